@@ -0,0 +1,200 @@
+#include "block.h"
+
+#include "mem_track.h"
+#include "world.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint8_t g_block_solid[BLOCK_MAX_TYPES];
+uint8_t g_block_opaque[BLOCK_MAX_TYPES];
+uint8_t g_block_emission[BLOCK_MAX_TYPES];
+uint8_t g_block_face_tile[BLOCK_MAX_TYPES][BLOCK_FACE_COUNT];
+float g_tile_uv[BLOCK_MAX_TILES][4];
+
+static BlockDef g_blocks[BLOCK_MAX_TYPES];
+static bool g_block_used[BLOCK_MAX_TYPES];
+static TileDef g_tiles[BLOCK_MAX_TILES];
+static int g_tile_count;
+static bool g_registry_inited;
+
+uint32_t block_rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    return (uint32_t)(r) | ((uint32_t)g << 8u) | ((uint32_t)b << 16u) | ((uint32_t)a << 24u);
+}
+
+int block_register_tile(const TileDef* def) {
+    if (!def || g_tile_count >= BLOCK_MAX_TILES) return -1;
+    g_tiles[g_tile_count] = *def;
+    return g_tile_count++;
+}
+
+bool block_register(uint8_t id, const BlockDef* def) {
+    if (!def) return false;
+    for (int f = 0; f < BLOCK_FACE_COUNT; f++) {
+        if (def->face_tiles[f] >= g_tile_count) return false;
+    }
+    g_blocks[id] = *def;
+    g_block_used[id] = true;
+    return true;
+}
+
+const BlockDef* block_def(uint8_t id) {
+    return g_block_used[id] ? &g_blocks[id] : NULL;
+}
+
+int block_tile_count(void) {
+    return g_tile_count;
+}
+
+uint64_t block_registry_hash(void) {
+    uint64_t h = 14695981039346656037ull;
+    const uint8_t* tables[4] = { g_block_solid, g_block_opaque, g_block_emission, &g_block_face_tile[0][0] };
+    const size_t sizes[4] = { sizeof(g_block_solid), sizeof(g_block_opaque), sizeof(g_block_emission), sizeof(g_block_face_tile) };
+    for (int t = 0; t < 4; t++) {
+        for (size_t i = 0; i < sizes[t]; i++) {
+            h ^= tables[t][i];
+            h *= 1099511628211ull;
+        }
+    }
+    h ^= (uint64_t)g_tile_count;
+    h *= 1099511628211ull;
+    return h;
+}
+
+static void atlas_size(int* out_w, int* out_h) {
+    int rows = (g_tile_count + ATLAS_TILES_PER_ROW - 1) / ATLAS_TILES_PER_ROW;
+    if (rows < 1) rows = 1;
+    *out_w = ATLAS_TILE_PX * ATLAS_TILES_PER_ROW;
+    *out_h = ATLAS_TILE_PX * rows;
+}
+
+void block_registry_compile(void) {
+    memset(g_block_solid, 0, sizeof(g_block_solid));
+    memset(g_block_opaque, 0, sizeof(g_block_opaque));
+    memset(g_block_emission, 0, sizeof(g_block_emission));
+    memset(g_block_face_tile, 0, sizeof(g_block_face_tile));
+
+    for (int id = 0; id < BLOCK_MAX_TYPES; id++) {
+        if (!g_block_used[id]) continue;
+        const BlockDef* b = &g_blocks[id];
+        g_block_solid[id] = b->solid ? 1 : 0;
+        g_block_opaque[id] = b->opaque ? 1 : 0;
+        g_block_emission[id] = b->emission > 15 ? 15 : b->emission;
+        memcpy(g_block_face_tile[id], b->face_tiles, sizeof(b->face_tiles));
+    }
+
+    int atlas_w, atlas_h;
+    atlas_size(&atlas_w, &atlas_h);
+    const float pad = 0.5f;
+    for (int t = 0; t < g_tile_count; t++) {
+        int tx = (t % ATLAS_TILES_PER_ROW) * ATLAS_TILE_PX;
+        int ty = (t / ATLAS_TILES_PER_ROW) * ATLAS_TILE_PX;
+        g_tile_uv[t][0] = ((float)tx + pad) / (float)atlas_w;
+        g_tile_uv[t][1] = ((float)ty + pad) / (float)atlas_h;
+        g_tile_uv[t][2] = ((float)(tx + ATLAS_TILE_PX) - pad) / (float)atlas_w;
+        g_tile_uv[t][3] = ((float)(ty + ATLAS_TILE_PX) - pad) / (float)atlas_h;
+    }
+}
+
+void block_registry_init(void) {
+    if (g_registry_inited) return;
+    g_registry_inited = true;
+
+    TileDef grass_top = { TILE_NOISE, { block_rgba(0x52, 0xA1, 0x3B, 0xFF), block_rgba(0x6B, 0xB7, 0x4D, 0xFF), block_rgba(0x3F, 0x8F, 0x2E, 0xFF) }, 0, 0, 0, 0 };
+    TileDef dirt = { TILE_NOISE, { block_rgba(0x8A, 0x6A, 0x3D, 0xFF), block_rgba(0x7A, 0x5D, 0x34, 0xFF), block_rgba(0x9A, 0x77, 0x46, 0xFF) }, 0, 0, 0, 0 };
+    TileDef stone = { TILE_NOISE, { block_rgba(0x86, 0x86, 0x86, 0xFF), block_rgba(0x74, 0x74, 0x74, 0xFF), block_rgba(0x96, 0x96, 0x96, 0xFF) }, 0, 0, 0, 0 };
+    TileDef lamp = { TILE_NOISE, { block_rgba(0xF2, 0xD2, 0x6B, 0xFF), block_rgba(0xFF, 0xE8, 0x9A, 0xFF), block_rgba(0xC9, 0xA2, 0x3E, 0xFF) }, 0, 0, 0, 0 };
+    TileDef sand = { TILE_NOISE, { block_rgba(0xDB, 0xCF, 0x8E, 0xFF), block_rgba(0xE8, 0xDD, 0xA3, 0xFF), block_rgba(0xC7, 0xB8, 0x77, 0xFF) }, 0, 0, 0, 0 };
+
+    int t_grass_top = block_register_tile(&grass_top);
+    int t_dirt = block_register_tile(&dirt);
+    int t_stone = block_register_tile(&stone);
+    int t_lamp = block_register_tile(&lamp);
+    int t_sand = block_register_tile(&sand);
+    TileDef grass_side = { TILE_BANDED, { 0 }, t_dirt, t_grass_top, 6, block_rgba(0x7A, 0xC9, 0x63, 0xFF) };
+    int t_grass_side = block_register_tile(&grass_side);
+
+    BlockDef air = { "air", false, false, 0, { 0 } };
+    BlockDef b_grass = { "grass", true, true, 0, { 0 } };
+    BlockDef b_dirt = { "dirt", true, true, 0, { 0 } };
+    BlockDef b_stone = { "stone", true, true, 0, { 0 } };
+    BlockDef b_lamp = { "lamp", true, true, 15, { 0 } };
+    BlockDef b_sand = { "sand", true, true, 0, { 0 } };
+    for (int f = 0; f < BLOCK_FACE_COUNT; f++) {
+        b_grass.face_tiles[f] = (uint8_t)t_grass_side;
+        b_dirt.face_tiles[f] = (uint8_t)t_dirt;
+        b_stone.face_tiles[f] = (uint8_t)t_stone;
+        b_lamp.face_tiles[f] = (uint8_t)t_lamp;
+        b_sand.face_tiles[f] = (uint8_t)t_sand;
+    }
+    b_grass.face_tiles[2] = (uint8_t)t_grass_top;
+    b_grass.face_tiles[3] = (uint8_t)t_dirt;
+
+    block_register(BLOCK_AIR, &air);
+    block_register(BLOCK_GRASS, &b_grass);
+    block_register(BLOCK_DIRT, &b_dirt);
+    block_register(BLOCK_STONE, &b_stone);
+    block_register(BLOCK_LAMP, &b_lamp);
+    block_register(BLOCK_SAND, &b_sand);
+
+    block_registry_compile();
+}
+
+static void make_noise_tile(uint32_t* out_rgba, int w, int h, uint32_t c0, uint32_t c1, uint32_t c2) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint32_t pick = (uint32_t)((x * 1973 + y * 9277 + x * y * 26699) & 7);
+            uint32_t c = (pick < 4) ? c0 : (pick < 6 ? c1 : c2);
+            out_rgba[y * w + x] = c;
+        }
+    }
+}
+
+static uint32_t* tile_pixels(uint32_t* rgba, int atlas_w, int t) {
+    int tx = (t % ATLAS_TILES_PER_ROW) * ATLAS_TILE_PX;
+    int ty = (t / ATLAS_TILES_PER_ROW) * ATLAS_TILE_PX;
+    return rgba + ty * atlas_w + tx;
+}
+
+uint32_t* block_build_atlas(int* out_w, int* out_h) {
+    const int tile = ATLAS_TILE_PX;
+    int atlas_w, atlas_h;
+    atlas_size(&atlas_w, &atlas_h);
+
+    uint32_t* rgba = (uint32_t*)mem_alloc(MEM_TAG_TEXTURE, (size_t)atlas_w * (size_t)atlas_h * sizeof(uint32_t));
+    if (!rgba) return NULL;
+    memset(rgba, 0, (size_t)atlas_w * (size_t)atlas_h * sizeof(uint32_t));
+
+    uint32_t scratch[ATLAS_TILE_PX * ATLAS_TILE_PX];
+    for (int t = 0; t < g_tile_count; t++) {
+        const TileDef* def = &g_tiles[t];
+        if (def->style != TILE_NOISE) continue;
+        make_noise_tile(scratch, tile, tile, def->colors[0], def->colors[1], def->colors[2]);
+        uint32_t* dst = tile_pixels(rgba, atlas_w, t);
+        for (int y = 0; y < tile; y++) {
+            memcpy(dst + y * atlas_w, scratch + y * tile, (size_t)tile * sizeof(uint32_t));
+        }
+    }
+
+    for (int t = 0; t < g_tile_count; t++) {
+        const TileDef* def = &g_tiles[t];
+        if (def->style != TILE_BANDED) continue;
+        const uint32_t* band = tile_pixels(rgba, atlas_w, def->band_tile);
+        const uint32_t* base = tile_pixels(rgba, atlas_w, def->base_tile);
+        uint32_t* dst = tile_pixels(rgba, atlas_w, t);
+        for (int y = 0; y < tile; y++) {
+            for (int x = 0; x < tile; x++) {
+                bool top_band = (y < def->band_rows);
+                uint32_t c = top_band ? band[y * atlas_w + x] : base[y * atlas_w + x];
+                if (top_band && ((x + y) & 7) == 0) c = def->accent;
+                dst[y * atlas_w + x] = c;
+            }
+        }
+    }
+
+    *out_w = atlas_w;
+    *out_h = atlas_h;
+    return rgba;
+}
@@ -0,0 +1,484 @@
+#include "block_tick.h"
+
+#include "chunk_slab.h"
+#include "light.h"
+#include "mem_track.h"
+#include "thread.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+static uint64_t tick_mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static bool block_falls(BlockType t) {
+    return t == BLOCK_SAND;
+}
+
+static bool grow_array(void** items, int* cap, int need, size_t item_size) {
+    if (need <= *cap) return true;
+    int new_cap = *cap ? *cap : 64;
+    while (new_cap < need) new_cap *= 2;
+    void* p = mem_realloc(MEM_TAG_WORLD, *items, (size_t)new_cap * item_size);
+    if (!p) return false;
+    *items = p;
+    *cap = new_cap;
+    return true;
+}
+
+static void queue_sift_up(TickQueue* q, int i) {
+    ScheduledTick item = q->items[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (q->items[parent].due <= item.due) break;
+        q->items[i] = q->items[parent];
+        i = parent;
+    }
+    q->items[i] = item;
+}
+
+static void queue_sift_down(TickQueue* q, int i) {
+    ScheduledTick item = q->items[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= q->count) break;
+        if (child + 1 < q->count && q->items[child + 1].due < q->items[child].due) child++;
+        if (item.due <= q->items[child].due) break;
+        q->items[i] = q->items[child];
+        i = child;
+    }
+    q->items[i] = item;
+}
+
+static ScheduledTick queue_pop(TickQueue* q) {
+    ScheduledTick top = q->items[0];
+    q->items[0] = q->items[--q->count];
+    if (q->count > 0) queue_sift_down(q, 0);
+    return top;
+}
+
+static int block_chunk_index(const World* world, int x, int y, int z) {
+    return (x >> CHUNK_SHIFT) + world->chunks_x * ((z >> CHUNK_SHIFT) + world->chunks_z * (y >> CHUNK_SHIFT));
+}
+
+static void queued_remove(BlockTicker* bt, int slot) {
+    bt->in_queued[bt->queued[slot]] = 0;
+    bt->queued[slot] = bt->queued[--bt->queued_count];
+    bt->stats.queued_chunks = bt->queued_count;
+}
+
+static void queued_add(BlockTicker* bt, int index) {
+    if (bt->in_queued[index]) return;
+    bt->in_queued[index] = 1;
+    bt->queued[bt->queued_count++] = index;
+    bt->stats.queued_chunks = bt->queued_count;
+}
+
+static void active_set(BlockTicker* bt, int index, bool active) {
+    if ((bt->active[index] != 0) == active) return;
+    bt->active[index] = active ? 1 : 0;
+    if (active) {
+        bt->active_slot[index] = bt->active_count;
+        bt->active_list[bt->active_count++] = index;
+        bt->stats.active_chunks = bt->active_count;
+        return;
+    }
+    int slot = bt->active_slot[index];
+    int last = bt->active_list[--bt->active_count];
+    bt->active_list[slot] = last;
+    bt->active_slot[last] = slot;
+    bt->active_slot[index] = -1;
+    if (bt->cursor >= bt->active_count) bt->cursor = 0;
+    bt->stats.active_chunks = bt->active_count;
+}
+
+void block_tick_schedule(BlockTicker* bt, int x, int y, int z, int delay) {
+    if (!bt || !bt->queues || !world_in_bounds(bt->world, x, y, z)) return;
+    if (delay < 1) delay = 1;
+
+    int index = block_chunk_index(bt->world, x, y, z);
+    uint16_t local = (uint16_t)chunk_local_index(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK);
+    uint64_t due = bt->tick + (uint64_t)delay;
+    TickQueue* q = &bt->queues[index];
+
+    for (int i = 0; i < q->count; i++) {
+        if (q->items[i].local != local) continue;
+        if (due < q->items[i].due) {
+            q->items[i].due = due;
+            queue_sift_up(q, i);
+        }
+        return;
+    }
+    if (!grow_array((void**)&q->items, &q->cap, q->count + 1, sizeof(ScheduledTick))) return;
+    q->items[q->count] = (ScheduledTick){ due, local };
+    queue_sift_up(q, q->count++);
+    bt->stats.pending++;
+    queued_add(bt, index);
+}
+
+void block_tick_notify(BlockTicker* bt, int x, int y, int z) {
+    if (!bt || !bt->world) return;
+    if (block_falls(world_get(bt->world, x, y, z))) block_tick_schedule(bt, x, y, z, BLOCK_TICK_FALL_DELAY);
+    if (block_falls(world_get(bt->world, x, y + 1, z))) block_tick_schedule(bt, x, y + 1, z, BLOCK_TICK_FALL_DELAY);
+}
+
+void block_tick_refresh_chunk(BlockTicker* bt, int index) {
+    if (!bt || !bt->active || index < 0 || index >= bt->chunk_count) return;
+    const Chunk* chunk = bt->world->chunks[index];
+    if (!chunk) return;
+    active_set(bt, index, memcmp(chunk->blocks, chunk->blocks + 1, CHUNK_VOLUME - 1) != 0);
+}
+
+static void emit(TickJob* job, TickEdit* out, int x, int y, int z, BlockType from, BlockType to) {
+    out[job->edit_count++] = (TickEdit){ { x, y, z, to }, (uint8_t)from };
+}
+
+static bool resident_get(const World* world, int x, int y, int z, BlockType* out) {
+    if (!world_in_bounds(world, x, y, z)) {
+        *out = BLOCK_AIR;
+        return true;
+    }
+    const Chunk* chunk = world->chunks[block_chunk_index(world, x, y, z)];
+    if (!chunk) return false;
+    *out = (BlockType)chunk->blocks[chunk_local_index(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)];
+    return true;
+}
+
+static bool neighbourhood_resident(const World* world, int index) {
+    if (!world->cache) return true;
+    int cx, cy, cz;
+    world_chunk_coords(world, index, &cx, &cy, &cz);
+    for (int y = cy - 1; y <= cy + 1; y++) {
+        for (int z = cz - 1; z <= cz + 1; z++) {
+            for (int x = cx - 1; x <= cx + 1; x++) {
+                if (x < 0 || y < 0 || z < 0 || x >= world->chunks_x || y >= world->chunks_y || z >= world->chunks_z) continue;
+                if (!world->chunks[x + world->chunks_x * (z + world->chunks_z * y)]) return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void tick_cell(const World* world, TickJob* job, TickEdit* out, int x, int y, int z, uint64_t bits) {
+    BlockType t, other;
+    if (!resident_get(world, x, y, z, &t)) return;
+    if (block_falls(t)) {
+        if (y > 0 && resident_get(world, x, y - 1, z, &other) && other == BLOCK_AIR) {
+            emit(job, out, x, y, z, t, BLOCK_AIR);
+            emit(job, out, x, y - 1, z, BLOCK_AIR, t);
+        }
+        return;
+    }
+    if (t == BLOCK_GRASS) {
+        if (resident_get(world, x, y + 1, z, &other) && world_is_opaque(other)) emit(job, out, x, y, z, t, BLOCK_DIRT);
+        return;
+    }
+    if (t == BLOCK_DIRT) {
+        if (!resident_get(world, x, y + 1, z, &other) || world_is_opaque(other)) return;
+        if (world->light_ready && light_get_sky(world, x, y + 1, z) < BLOCK_TICK_GRASS_LIGHT) return;
+        int dx = (int)(bits % 3u) - 1;
+        int dz = (int)((bits / 3u) % 3u) - 1;
+        int dy = (int)((bits / 9u) % 5u) - 3;
+        if (resident_get(world, x + dx, y + dy, z + dz, &other) && other == BLOCK_GRASS) emit(job, out, x, y, z, t, BLOCK_GRASS);
+    }
+}
+
+static void run_job(BlockTicker* bt, TickJob* job) {
+    const World* world = bt->world;
+    TickEdit* out = bt->edits + job->first_edit;
+    int cx, cy, cz;
+    world_chunk_coords(world, job->chunk, &cx, &cy, &cz);
+    int bx = cx << CHUNK_SHIFT;
+    int by = cy << CHUNK_SHIFT;
+    int bz = cz << CHUNK_SHIFT;
+
+    job->edit_count = 0;
+    for (int i = 0; i < job->scheduled; i++) {
+        int local = bt->due[job->first_scheduled + i];
+        int lx = local & CHUNK_MASK;
+        int lz = (local >> CHUNK_SHIFT) & CHUNK_MASK;
+        int ly = local >> (2 * CHUNK_SHIFT);
+        tick_cell(world, job, out, bx + lx, by + ly, bz + lz, tick_mix(bt->seed ^ bt->tick ^ ((uint64_t)local << 32)));
+    }
+
+    uint64_t rng = bt->seed ^ (bt->tick * 0xD1B54A32D192ED03ull) ^ ((uint64_t)job->chunk << 20);
+    for (int i = 0; i < job->random; i++) {
+        uint64_t r = tick_mix(rng + (uint64_t)i);
+        int local = (int)(r & (CHUNK_VOLUME - 1));
+        int lx = local & CHUNK_MASK;
+        int lz = (local >> CHUNK_SHIFT) & CHUNK_MASK;
+        int ly = local >> (2 * CHUNK_SHIFT);
+        tick_cell(world, job, out, bx + lx, by + ly, bz + lz, r >> 12);
+    }
+}
+
+static void tick_worker(void* user) {
+    BlockTicker* bt = (BlockTicker*)user;
+    for (;;) {
+        mutex_lock(bt->lock);
+        int first = bt->next_job;
+        bt->next_job += BLOCK_TICK_BATCH;
+        mutex_unlock(bt->lock);
+        if (first >= bt->job_count) break;
+
+        int last = first + BLOCK_TICK_BATCH < bt->job_count ? first + BLOCK_TICK_BATCH : bt->job_count;
+        for (int i = first; i < last; i++) run_job(bt, &bt->jobs[i]);
+    }
+}
+
+static void tick_pool_main(void* user) {
+    BlockTicker* bt = (BlockTicker*)user;
+    uint64_t seen = 0;
+    mutex_lock(bt->lock);
+    for (;;) {
+        while (!bt->quit && bt->generation == seen) condvar_wait(bt->wake, bt->lock);
+        if (bt->quit) break;
+        seen = bt->generation;
+        mutex_unlock(bt->lock);
+        tick_worker(bt);
+        mutex_lock(bt->lock);
+        if (--bt->busy == 0) condvar_signal(bt->idle);
+    }
+    mutex_unlock(bt->lock);
+    chunk_slab_thread_flush();
+}
+
+static void run_workers(BlockTicker* bt) {
+    mutex_lock(bt->lock);
+    bt->next_job = 0;
+    bt->busy = bt->worker_count;
+    bt->generation++;
+    condvar_broadcast(bt->wake);
+    mutex_unlock(bt->lock);
+
+    tick_worker(bt);
+
+    mutex_lock(bt->lock);
+    while (bt->busy > 0) condvar_wait(bt->idle, bt->lock);
+    mutex_unlock(bt->lock);
+}
+
+static void stop_workers(BlockTicker* bt) {
+    if (bt->worker_count > 0) {
+        mutex_lock(bt->lock);
+        bt->quit = true;
+        condvar_broadcast(bt->wake);
+        mutex_unlock(bt->lock);
+        for (int i = 0; i < bt->worker_count; i++) thread_join(bt->workers[i]);
+        bt->worker_count = 0;
+    }
+    if (bt->wake) condvar_destroy(bt->wake);
+    if (bt->idle) condvar_destroy(bt->idle);
+    if (bt->lock) mutex_destroy(bt->lock);
+    bt->wake = NULL;
+    bt->idle = NULL;
+    bt->lock = NULL;
+}
+
+static void start_workers(BlockTicker* bt) {
+    if (bt->thread_count <= 1) return;
+    if (!mutex_create(&bt->lock) || !condvar_create(&bt->wake) || !condvar_create(&bt->idle)) {
+        stop_workers(bt);
+        bt->thread_count = 1;
+        return;
+    }
+    for (int i = 1; i < bt->thread_count; i++) {
+        if (!thread_create(&bt->workers[bt->worker_count], tick_pool_main, bt)) break;
+        bt->worker_count++;
+    }
+    bt->thread_count = bt->worker_count + 1;
+}
+
+bool block_tick_init(BlockTicker* bt, World* world, BlockTickDesc desc) {
+    memset(bt, 0, sizeof(*bt));
+    if (!world || !world->chunks) return false;
+
+    int n = world_chunk_count(world);
+    bt->world = world;
+    bt->seed = desc.seed;
+    bt->chunk_count = n;
+    bt->random_per_chunk = desc.random_per_chunk >= 0 ? desc.random_per_chunk : BLOCK_TICK_RANDOM_PER_CHUNK;
+    bt->budget = desc.budget > 0 ? desc.budget : BLOCK_TICK_DEFAULT_BUDGET;
+    bt->thread_count = desc.threads > 0 ? desc.threads : 1;
+    if (bt->thread_count > BLOCK_TICK_MAX_THREADS) bt->thread_count = BLOCK_TICK_MAX_THREADS;
+
+    bt->queues = (TickQueue*)mem_calloc(MEM_TAG_WORLD, (size_t)n, sizeof(TickQueue));
+    bt->queued = (int*)mem_alloc(MEM_TAG_WORLD, (size_t)n * sizeof(int));
+    bt->in_queued = (uint8_t*)mem_calloc(MEM_TAG_WORLD, (size_t)n, 1);
+    bt->active = (uint8_t*)mem_calloc(MEM_TAG_WORLD, (size_t)n, 1);
+    bt->active_list = (int*)mem_alloc(MEM_TAG_WORLD, (size_t)n * sizeof(int));
+    bt->active_slot = (int*)mem_alloc(MEM_TAG_WORLD, (size_t)n * sizeof(int));
+    if (!bt->queues || !bt->queued || !bt->in_queued || !bt->active || !bt->active_list || !bt->active_slot) {
+        block_tick_shutdown(bt);
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        bt->active_slot[i] = -1;
+        block_tick_refresh_chunk(bt, i);
+    }
+    start_workers(bt);
+    return true;
+}
+
+void block_tick_shutdown(BlockTicker* bt) {
+    if (!bt) return;
+    stop_workers(bt);
+    if (bt->queues) {
+        for (int i = 0; i < bt->chunk_count; i++) mem_free(MEM_TAG_WORLD, bt->queues[i].items);
+    }
+    mem_free(MEM_TAG_WORLD, bt->queues);
+    mem_free(MEM_TAG_WORLD, bt->queued);
+    mem_free(MEM_TAG_WORLD, bt->in_queued);
+    mem_free(MEM_TAG_WORLD, bt->active);
+    mem_free(MEM_TAG_WORLD, bt->active_list);
+    mem_free(MEM_TAG_WORLD, bt->active_slot);
+    mem_free(MEM_TAG_WORLD, bt->jobs);
+    mem_free(MEM_TAG_WORLD, bt->due);
+    mem_free(MEM_TAG_WORLD, bt->edits);
+    mem_free(MEM_TAG_WORLD, bt->apply);
+    memset(bt, 0, sizeof(*bt));
+}
+
+static TickJob* push_job(BlockTicker* bt, int chunk) {
+    if (!grow_array((void**)&bt->jobs, &bt->job_cap, bt->job_count + 1, sizeof(TickJob))) return NULL;
+    TickJob* job = &bt->jobs[bt->job_count++];
+    memset(job, 0, sizeof(*job));
+    job->chunk = chunk;
+    job->first_scheduled = bt->due_count;
+    return job;
+}
+
+static int collect_scheduled(BlockTicker* bt, uint64_t prev, uint64_t tick, int budget) {
+    int used = 0;
+    for (int s = 0; s < bt->queued_count;) {
+        int index = bt->queued[s];
+        TickQueue* q = &bt->queues[index];
+        if (q->count > 0 && q->items[0].due <= tick && used < budget && neighbourhood_resident(bt->world, index)) {
+            TickJob* job = push_job(bt, index);
+            while (job && q->count > 0 && q->items[0].due <= tick && used < budget) {
+                if (!grow_array((void**)&bt->due, &bt->due_cap, bt->due_count + 1, sizeof(uint16_t))) break;
+                bt->due[bt->due_count++] = queue_pop(q).local;
+                bt->stats.pending--;
+                job->scheduled++;
+                used++;
+            }
+        }
+        for (int i = 0; i < q->count; i++) {
+            if (q->items[i].due > prev && q->items[i].due <= tick) bt->stats.deferred++;
+        }
+        if (q->count == 0) {
+            queued_remove(bt, s);
+            continue;
+        }
+        s++;
+    }
+    return used;
+}
+
+static int collect_random(BlockTicker* bt, int budget) {
+    if (bt->random_per_chunk <= 0 || bt->active_count == 0) return 0;
+    int chunks = budget / bt->random_per_chunk;
+    int added = 0;
+    int scanned = 0;
+    for (; scanned < bt->active_count && added < chunks; scanned++) {
+        int index = bt->active_list[(bt->cursor + scanned) % bt->active_count];
+        if (!bt->world->chunks[index]) continue;
+        TickJob* job = push_job(bt, index);
+        if (!job) break;
+        job->random = bt->random_per_chunk;
+        added++;
+    }
+    bt->cursor = (bt->cursor + scanned) % bt->active_count;
+    return added * bt->random_per_chunk;
+}
+
+static void requeue_scheduled(BlockTicker* bt, uint64_t tick) {
+    for (int j = 0; j < bt->job_count; j++) {
+        const TickJob* job = &bt->jobs[j];
+        if (job->scheduled == 0) continue;
+        TickQueue* q = &bt->queues[job->chunk];
+        for (int i = 0; i < job->scheduled; i++) {
+            q->items[q->count] = (ScheduledTick){ tick, bt->due[job->first_scheduled + i] };
+            queue_sift_up(q, q->count++);
+            bt->stats.pending++;
+            bt->stats.deferred++;
+        }
+        queued_add(bt, job->chunk);
+    }
+    bt->job_count = 0;
+}
+
+void block_tick_evaluate(BlockTicker* bt, uint64_t tick) {
+    if (!bt || !bt->queues) return;
+    uint64_t prev = bt->tick;
+    bt->tick = tick;
+    bt->job_count = 0;
+    bt->due_count = 0;
+
+    int scheduled = collect_scheduled(bt, prev, tick, bt->budget);
+    int random = collect_random(bt, bt->budget - scheduled);
+
+    int edit_total = 0;
+    for (int i = 0; i < bt->job_count; i++) {
+        bt->jobs[i].first_edit = edit_total;
+        edit_total += 2 * (bt->jobs[i].scheduled + bt->jobs[i].random);
+    }
+    if (!grow_array((void**)&bt->edits, &bt->edit_cap, edit_total, sizeof(TickEdit)) || !grow_array((void**)&bt->apply, &bt->apply_cap, edit_total, sizeof(BlockEdit))) {
+        requeue_scheduled(bt, tick);
+        return;
+    }
+    bt->stats.scheduled_run += (uint64_t)scheduled;
+    bt->stats.random_run += (uint64_t)random;
+
+    if (bt->worker_count == 0 || scheduled + random < BLOCK_TICK_PARALLEL_MIN) {
+        for (int i = 0; i < bt->job_count; i++) run_job(bt, &bt->jobs[i]);
+        return;
+    }
+    run_workers(bt);
+}
+
+int block_tick_apply(BlockTicker* bt) {
+    if (!bt || !bt->queues) return 0;
+    World* world = bt->world;
+
+    int count = 0;
+    for (int j = 0; j < bt->job_count; j++) {
+        const TickJob* job = &bt->jobs[j];
+        for (int i = 0; i < job->edit_count; i++) {
+            const TickEdit* e = &bt->edits[job->first_edit + i];
+            if ((uint8_t)world_get(world, e->edit.x, e->edit.y, e->edit.z) != e->expect) continue;
+            bt->apply[count++] = e->edit;
+        }
+    }
+    bt->job_count = 0;
+    bt->stats.ticks++;
+    if (count == 0) return 0;
+
+    int changed = world_apply_edits(world, bt->apply, (size_t)count);
+    bt->stats.changed += (uint64_t)changed;
+
+    int refreshed = -1;
+    for (int i = 0; i < count; i++) {
+        const BlockEdit* e = &bt->apply[i];
+        block_tick_notify(bt, e->x, e->y, e->z);
+        int index = block_chunk_index(world, e->x, e->y, e->z);
+        if (index == refreshed) continue;
+        block_tick_refresh_chunk(bt, index);
+        refreshed = index;
+    }
+    return changed;
+}
+
+int block_tick_step(BlockTicker* bt, uint64_t tick) {
+    block_tick_evaluate(bt, tick);
+    return block_tick_apply(bt);
+}
+
+const BlockTickStats* block_tick_stats(const BlockTicker* bt) {
+    return &bt->stats;
+}
@@ -36,3 +36,37 @@ void camera_apply_mouse(Camera* cam, int mouse_dx, int mouse_dy, float sensitivi
     cam->pitch -= (float)mouse_dy * sensitivity;
     cam->pitch = clampf(cam->pitch, -1.55f, 1.55f);
 }
+
+Camera camera_lerp(const Camera* a, const Camera* b, float t) {
+    Camera c = *b;
+    c.position_feet.x = a->position_feet.x + (b->position_feet.x - a->position_feet.x) * t;
+    c.position_feet.y = a->position_feet.y + (b->position_feet.y - a->position_feet.y) * t;
+    c.position_feet.z = a->position_feet.z + (b->position_feet.z - a->position_feet.z) * t;
+    c.yaw = a->yaw + (b->yaw - a->yaw) * t;
+    c.pitch = a->pitch + (b->pitch - a->pitch) * t;
+    return c;
+}
+
+Vec3 camera_eye(const Camera* cam) {
+    const float eye_height = 1.62f;
+    return (Vec3){ cam->position_feet.x, cam->position_feet.y + eye_height, cam->position_feet.z };
+}
+
+Mat4 camera_view_proj(const Camera* cam, int width, int height) {
+    Vec3 eye = camera_eye(cam);
+
+    float cy = cosf(cam->yaw);
+    float sy = sinf(cam->yaw);
+    float cp = cosf(cam->pitch);
+    float sp = sinf(cam->pitch);
+
+    Vec3 forward = (Vec3){ sy * cp, sp, -cy * cp };
+    forward = vec3_norm(forward);
+
+    Mat4 view = mat4_look(eye, forward, (Vec3){ 0.0f, 1.0f, 0.0f });
+    float aspect = (height > 0) ? ((float)width / (float)height) : 1.0f;
+    Mat4 proj = mat4_perspective(70.0f * (3.14159265f / 180.0f), aspect, 0.05f, 300.0f);
+    Mat4 vp;
+    mat4_mul_p(&vp, &proj, &view);
+    return vp;
+}
@@ -0,0 +1,326 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "chunk_cache.h"
+
+#include "chunk_slab.h"
+#include "mem_track.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_MODIFIED 0x01
+#define CACHE_STORED 0x02
+#define CACHE_UNIFORM 0x04
+#define CACHE_MESH_DROPPED 0x08
+
+#define CACHE_MIN_IDLE_FRAMES 2u
+
+static const uint64_t* g_sort_keys;
+
+static int compare_keys(const void* a, const void* b) {
+    uint64_t ka = g_sort_keys[*(const int*)a];
+    uint64_t kb = g_sort_keys[*(const int*)b];
+    return (ka > kb) - (ka < kb);
+}
+
+static bool seek_record(FILE* f, uint32_t slot) {
+    uint64_t offset = (uint64_t)slot * CHUNK_CACHE_RECORD_BYTES;
+#ifdef _WIN32
+    return _fseeki64(f, (__int64)offset, SEEK_SET) == 0;
+#else
+    return fseeko(f, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+static bool is_uniform(const uint8_t* p, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        if (p[i] != p[0]) return false;
+    }
+    return true;
+}
+
+static float box_distance_sq(Vec3 p, Vec3 lo, Vec3 hi) {
+    float dx = p.x < lo.x ? lo.x - p.x : (p.x > hi.x ? p.x - hi.x : 0.0f);
+    float dy = p.y < lo.y ? lo.y - p.y : (p.y > hi.y ? p.y - hi.y : 0.0f);
+    float dz = p.z < lo.z ? lo.z - p.z : (p.z > hi.z ? p.z - hi.z : 0.0f);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+bool chunk_cache_init(ChunkCache* c, World* world, const char* backing_path, size_t block_budget, size_t mesh_budget) {
+    memset(c, 0, sizeof(*c));
+    if (!world || !world->chunks || world->cache) return false;
+
+    size_t n = (size_t)world_chunk_count(world);
+    c->block_used = (uint32_t*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(uint32_t));
+    c->mesh_used = (uint32_t*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(uint32_t));
+    c->mesh_size = (size_t*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(size_t));
+    c->state = (uint8_t*)mem_calloc(MEM_TAG_SCRATCH, n, 1);
+    c->uniform = (uint8_t*)mem_calloc(MEM_TAG_SCRATCH, n, 2);
+    c->order = (int*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(int));
+    c->keys = (uint64_t*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(uint64_t));
+    c->mins = (Vec3*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(Vec3));
+    c->maxs = (Vec3*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(Vec3));
+    c->visible = (uint8_t*)mem_calloc(MEM_TAG_SCRATCH, n, 1);
+    c->slot = (uint32_t*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(uint32_t));
+    c->held = (uint8_t*)mem_calloc(MEM_TAG_SCRATCH, n, 1);
+    c->free_slots = (uint32_t*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(uint32_t));
+    c->retired = (uint32_t*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(uint32_t));
+    if (!c->block_used || !c->mesh_used || !c->mesh_size || !c->state || !c->uniform || !c->order || !c->keys ||
+        !c->mins || !c->maxs || !c->visible || !c->slot || !c->held || !c->free_slots || !c->retired) {
+        chunk_cache_shutdown(c);
+        return false;
+    }
+    if (block_budget > 0) {
+        if (!world_adopt_external_chunks(world)) {
+            chunk_cache_shutdown(c);
+            return false;
+        }
+        c->backing = fopen(backing_path, "w+b");
+        if (!c->backing) {
+            chunk_cache_shutdown(c);
+            return false;
+        }
+        snprintf(c->backing_path, sizeof(c->backing_path), "%s", backing_path);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        int cx, cy, cz;
+        world_chunk_coords(world, (int)i, &cx, &cy, &cz);
+        c->mins[i] = (Vec3){ (float)(cx << CHUNK_SHIFT), (float)(cy << CHUNK_SHIFT), (float)(cz << CHUNK_SHIFT) };
+        c->maxs[i] = (Vec3){ c->mins[i].x + (float)CHUNK_SIZE, c->mins[i].y + (float)CHUNK_SIZE, c->mins[i].z + (float)CHUNK_SIZE };
+        c->state[i] = CACHE_MODIFIED;
+        c->slot[i] = (uint32_t)i;
+    }
+
+    c->world = world;
+    c->chunk_count = (int)n;
+    c->slot_count = (uint32_t)n;
+    c->block_budget = block_budget;
+    c->mesh_budget = mesh_budget;
+    c->stats.resident_chunks = (int)n;
+    c->stats.block_bytes = n * sizeof(Chunk);
+    world->cache = c;
+    return true;
+}
+
+void chunk_cache_shutdown(ChunkCache* c) {
+    if (!c) return;
+    if (c->world) {
+        for (int i = 0; i < c->chunk_count; i++) {
+            if (!c->world->chunks[i]) chunk_cache_fault(c, i);
+        }
+        c->world->cache = NULL;
+    }
+    if (c->backing) {
+        fclose(c->backing);
+    }
+    mem_free(MEM_TAG_SCRATCH, c->block_used);
+    mem_free(MEM_TAG_SCRATCH, c->mesh_used);
+    mem_free(MEM_TAG_SCRATCH, c->mesh_size);
+    mem_free(MEM_TAG_SCRATCH, c->state);
+    mem_free(MEM_TAG_SCRATCH, c->uniform);
+    mem_free(MEM_TAG_SCRATCH, c->order);
+    mem_free(MEM_TAG_SCRATCH, c->keys);
+    mem_free(MEM_TAG_SCRATCH, c->mins);
+    mem_free(MEM_TAG_SCRATCH, c->maxs);
+    mem_free(MEM_TAG_SCRATCH, c->visible);
+    mem_free(MEM_TAG_SCRATCH, c->slot);
+    mem_free(MEM_TAG_SCRATCH, c->held);
+    mem_free(MEM_TAG_SCRATCH, c->free_slots);
+    mem_free(MEM_TAG_SCRATCH, c->retired);
+    memset(c, 0, sizeof(*c));
+}
+
+bool chunk_cache_read_record(FILE* f, uint32_t slot, Chunk* out) {
+    return seek_record(f, slot) &&
+        fread(out->blocks, sizeof(out->blocks), 1, f) == 1 &&
+        fread(out->light, sizeof(out->light), 1, f) == 1;
+}
+
+Chunk* chunk_cache_fault(ChunkCache* c, int index) {
+    Chunk* chunk = chunk_slab_alloc();
+    bool ok = chunk != NULL;
+    if (ok && (c->state[index] & CACHE_UNIFORM)) {
+        memset(chunk->blocks, c->uniform[index * 2], sizeof(chunk->blocks));
+        memset(chunk->light, c->uniform[index * 2 + 1], sizeof(chunk->light));
+    } else if (ok) {
+        ok = chunk_cache_read_record(c->backing, c->slot[index], chunk);
+    }
+    if (!ok) {
+        fprintf(stderr, "chunk cache: cannot reload chunk %d\n", index);
+        abort();
+    }
+    chunk->dirty = false;
+    c->state[index] &= (uint8_t)~(CACHE_UNIFORM | CACHE_MODIFIED);
+    c->world->chunks[index] = chunk;
+    c->block_used[index] = c->clock;
+    c->stats.misses++;
+    c->stats.resident_chunks++;
+    c->stats.block_bytes += sizeof(Chunk);
+    return chunk;
+}
+
+void chunk_cache_touch(ChunkCache* c, int index) {
+    c->block_used[index] = c->clock;
+    if (c->world->chunks[index]) {
+        c->stats.hits++;
+        return;
+    }
+    chunk_cache_fault(c, index);
+}
+
+void chunk_cache_note_write(ChunkCache* c, int index) {
+    c->state[index] |= CACHE_MODIFIED;
+    c->block_used[index] = c->clock;
+}
+
+bool chunk_cache_hold_records(ChunkCache* c) {
+    if (c->holding) return false;
+    if (c->backing && fflush(c->backing) != 0) return false;
+    for (int i = 0; i < c->chunk_count; i++) {
+        c->held[i] = !c->world->chunks[i] && (c->state[i] & CACHE_STORED) && !(c->state[i] & CACHE_UNIFORM);
+    }
+    c->holding = true;
+    return true;
+}
+
+void chunk_cache_release_records(ChunkCache* c) {
+    if (!c->holding) return;
+    memset(c->held, 0, (size_t)c->chunk_count);
+    for (int i = 0; i < c->retired_count; i++) c->free_slots[c->free_count++] = c->retired[i];
+    c->retired_count = 0;
+    c->holding = false;
+}
+
+bool chunk_cache_stored_record(const ChunkCache* c, int index, uint32_t* out_slot, uint8_t out_uniform[2]) {
+    if (c->world->chunks[index]) return false;
+    if (c->state[index] & CACHE_UNIFORM) {
+        out_uniform[0] = c->uniform[index * 2];
+        out_uniform[1] = c->uniform[index * 2 + 1];
+        *out_slot = CHUNK_CACHE_NO_SLOT;
+    } else {
+        *out_slot = c->slot[index];
+    }
+    return true;
+}
+
+static void move_held_record(ChunkCache* c, int index) {
+    c->retired[c->retired_count++] = c->slot[index];
+    c->slot[index] = c->free_count > 0 ? c->free_slots[--c->free_count] : c->slot_count++;
+    c->held[index] = 0;
+}
+
+static bool evict_chunk(ChunkCache* c, int index) {
+    Chunk* chunk = c->world->chunks[index];
+    if (is_uniform(chunk->blocks, sizeof(chunk->blocks)) && is_uniform(chunk->light, sizeof(chunk->light))) {
+        c->uniform[index * 2] = chunk->blocks[0];
+        c->uniform[index * 2 + 1] = chunk->light[0];
+        c->state[index] |= CACHE_UNIFORM;
+        c->stats.uniform_evictions++;
+    } else if ((c->state[index] & CACHE_MODIFIED) || !(c->state[index] & CACHE_STORED)) {
+        if (c->held[index]) move_held_record(c, index);
+        bool ok = seek_record(c->backing, c->slot[index]) &&
+            fwrite(chunk->blocks, sizeof(chunk->blocks), 1, c->backing) == 1 &&
+            fwrite(chunk->light, sizeof(chunk->light), 1, c->backing) == 1;
+        if (!ok) return false;
+        c->state[index] |= CACHE_STORED;
+        c->stats.writebacks++;
+    }
+    c->state[index] &= (uint8_t)~CACHE_MODIFIED;
+    chunk_slab_release(chunk);
+    c->world->chunks[index] = NULL;
+    c->stats.resident_chunks--;
+    c->stats.block_bytes -= sizeof(Chunk);
+    c->stats.evictions++;
+    return true;
+}
+
+void chunk_cache_begin_frame(ChunkCache* c, Vec3 eye, Mat4 view_proj, float view_distance) {
+    c->clock++;
+    c->eye = eye;
+
+    Vec4 planes[6];
+    mat4_frustum_planes(&view_proj, planes);
+    aabb_cull_planes(planes, c->mins, c->maxs, c->visible, (size_t)c->chunk_count);
+    float max_sq = view_distance * view_distance;
+    for (int i = 0; i < c->chunk_count; i++) {
+        if (!c->visible[i]) continue;
+        if (view_distance > 0.0f && box_distance_sq(eye, c->mins[i], c->maxs[i]) > max_sq) continue;
+        c->mesh_used[i] = c->clock;
+    }
+}
+
+void chunk_cache_set_mesh_bytes(ChunkCache* c, int index, size_t bytes) {
+    if (c->mesh_size[index] == bytes) return;
+    if (c->mesh_size[index] > 0) c->stats.resident_meshes--;
+    if (bytes > 0) c->stats.resident_meshes++;
+    c->stats.mesh_bytes = c->stats.mesh_bytes - c->mesh_size[index] + bytes;
+    c->mesh_size[index] = bytes;
+    if (bytes > 0) c->state[index] &= (uint8_t)~CACHE_MESH_DROPPED;
+}
+
+int chunk_cache_trim_meshes(ChunkCache* c, int* out_indices, int max_indices) {
+    if (c->mesh_budget == 0 || c->stats.mesh_bytes <= c->mesh_budget) return 0;
+
+    int n = 0;
+    for (int i = 0; i < c->chunk_count; i++) {
+        if (c->mesh_size[i] == 0 || c->mesh_used[i] == c->clock) continue;
+        c->keys[i] = c->mesh_used[i];
+        c->order[n++] = i;
+    }
+    g_sort_keys = c->keys;
+    qsort(c->order, (size_t)n, sizeof(int), compare_keys);
+
+    int taken = 0;
+    for (int k = 0; k < n && taken < max_indices && c->stats.mesh_bytes > c->mesh_budget; k++) {
+        int i = c->order[k];
+        chunk_cache_set_mesh_bytes(c, i, 0);
+        c->state[i] |= CACHE_MESH_DROPPED;
+        c->stats.mesh_evictions++;
+        out_indices[taken++] = i;
+    }
+    return taken;
+}
+
+int chunk_cache_take_mesh_reloads(ChunkCache* c, int* out_indices, int max_indices) {
+    int taken = 0;
+    for (int i = 0; i < c->chunk_count && taken < max_indices; i++) {
+        if (!(c->state[i] & CACHE_MESH_DROPPED) || c->mesh_used[i] != c->clock) continue;
+        c->state[i] &= (uint8_t)~CACHE_MESH_DROPPED;
+        c->stats.mesh_reloads++;
+        out_indices[taken++] = i;
+    }
+    return taken;
+}
+
+int chunk_cache_trim_blocks(ChunkCache* c) {
+    if (!c->backing || c->stats.block_bytes <= c->block_budget) return 0;
+
+    Chunk** chunks = c->world->chunks;
+    float pin_sq = CHUNK_CACHE_PIN_RADIUS * CHUNK_CACHE_PIN_RADIUS;
+    int n = 0;
+    for (int i = 0; i < c->chunk_count; i++) {
+        if (!chunks[i] || chunks[i]->dirty || c->clock - c->block_used[i] < CACHE_MIN_IDLE_FRAMES) continue;
+        if (box_distance_sq(c->eye, c->mins[i], c->maxs[i]) < pin_sq) continue;
+        c->keys[i] = ((uint64_t)(c->mesh_size[i] > 0) << 32) | c->block_used[i];
+        c->order[n++] = i;
+    }
+    g_sort_keys = c->keys;
+    qsort(c->order, (size_t)n, sizeof(int), compare_keys);
+
+    int evicted = 0;
+    for (int k = 0; k < n && c->stats.block_bytes > c->block_budget; k++) {
+        if (!evict_chunk(c, c->order[k])) break;
+        evicted++;
+    }
+    return evicted;
+}
+
+const ChunkCacheStats* chunk_cache_stats(const ChunkCache* c) {
+    return &c->stats;
+}
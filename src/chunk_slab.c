@@ -0,0 +1,175 @@
+#include "chunk_slab.h"
+
+#include "mem_track.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define SLAB_MASK (CHUNK_SLAB_CHUNKS - 1)
+#define SLAB_NONE 0xFFFFFFFFu
+
+typedef struct SlabSlot {
+    uint32_t index;
+    _Atomic uint32_t next;
+    atomic_int refs;
+    Chunk chunk;
+} SlabSlot;
+
+typedef struct SlabCache {
+    int count;
+    uint32_t items[CHUNK_SLAB_CACHE];
+} SlabCache;
+
+static SlabSlot* g_slabs[CHUNK_SLAB_MAX_SLABS];
+static atomic_int g_slab_count;
+static atomic_uint_least64_t g_free_head = SLAB_NONE;
+static atomic_int g_live;
+static atomic_uint_least64_t g_allocs;
+static atomic_uint_least64_t g_frees;
+static atomic_uint_least64_t g_refills;
+static atomic_uint_least64_t g_flushes;
+
+static _Thread_local SlabCache t_cache;
+
+static SlabSlot* slot_at(uint32_t index) {
+    return &g_slabs[index >> CHUNK_SLAB_SHIFT][index & SLAB_MASK];
+}
+
+static void global_push(uint32_t first, uint32_t last) {
+    uint64_t head = atomic_load_explicit(&g_free_head, memory_order_relaxed);
+    uint64_t next;
+    do {
+        atomic_store_explicit(&slot_at(last)->next, (uint32_t)head, memory_order_relaxed);
+        next = ((head >> 32) + 1) << 32 | first;
+    } while (!atomic_compare_exchange_weak_explicit(&g_free_head, &head, next, memory_order_release, memory_order_relaxed));
+}
+
+static uint32_t global_pop(void) {
+    uint64_t head = atomic_load_explicit(&g_free_head, memory_order_acquire);
+    for (;;) {
+        uint32_t index = (uint32_t)head;
+        if (index == SLAB_NONE) return SLAB_NONE;
+        uint32_t after = atomic_load_explicit(&slot_at(index)->next, memory_order_relaxed);
+        uint64_t next = ((head >> 32) + 1) << 32 | after;
+        if (atomic_compare_exchange_weak_explicit(&g_free_head, &head, next, memory_order_acquire, memory_order_acquire)) {
+            return index;
+        }
+    }
+}
+
+static bool grow(void) {
+    int slab = atomic_fetch_add(&g_slab_count, 1);
+    if (slab >= CHUNK_SLAB_MAX_SLABS) {
+        atomic_fetch_sub(&g_slab_count, 1);
+        return false;
+    }
+    SlabSlot* slots = (SlabSlot*)mem_alloc(MEM_TAG_WORLD, CHUNK_SLAB_CHUNKS * sizeof(SlabSlot));
+    if (!slots) {
+        g_slabs[slab] = NULL;
+        int expected = slab + 1;
+        atomic_compare_exchange_strong(&g_slab_count, &expected, slab);
+        return false;
+    }
+    uint32_t base = (uint32_t)slab << CHUNK_SLAB_SHIFT;
+    for (uint32_t i = 0; i < CHUNK_SLAB_CHUNKS; i++) {
+        slots[i].index = base + i;
+        atomic_init(&slots[i].next, i + 1 < CHUNK_SLAB_CHUNKS ? base + i + 1 : SLAB_NONE);
+    }
+    g_slabs[slab] = slots;
+    global_push(base, base + CHUNK_SLAB_CHUNKS - 1);
+    return true;
+}
+
+static bool refill(SlabCache* cache) {
+    atomic_fetch_add(&g_refills, 1);
+    while (cache->count < CHUNK_SLAB_CACHE / 2) {
+        uint32_t index = global_pop();
+        if (index == SLAB_NONE) {
+            if (cache->count > 0) break;
+            if (!grow()) return false;
+            continue;
+        }
+        cache->items[cache->count++] = index;
+    }
+    return true;
+}
+
+static void flush(SlabCache* cache, int keep) {
+    if (cache->count <= keep) return;
+    atomic_fetch_add(&g_flushes, 1);
+    for (int i = keep; i < cache->count - 1; i++) {
+        atomic_store_explicit(&slot_at(cache->items[i])->next, cache->items[i + 1], memory_order_relaxed);
+    }
+    global_push(cache->items[keep], cache->items[cache->count - 1]);
+    cache->count = keep;
+}
+
+Chunk* chunk_slab_alloc(void) {
+    SlabCache* cache = &t_cache;
+    if (cache->count == 0 && !refill(cache)) return NULL;
+    SlabSlot* slot = slot_at(cache->items[--cache->count]);
+    atomic_store_explicit(&slot->refs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_live, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_allocs, 1, memory_order_relaxed);
+    return &slot->chunk;
+}
+
+Chunk* chunk_slab_calloc(void) {
+    Chunk* chunk = chunk_slab_alloc();
+    if (chunk) memset(chunk, 0, sizeof(*chunk));
+    return chunk;
+}
+
+static SlabSlot* slot_of(const Chunk* chunk) {
+    return (SlabSlot*)((uint8_t*)chunk - offsetof(SlabSlot, chunk));
+}
+
+void chunk_slab_retain(Chunk* chunk) {
+    atomic_fetch_add_explicit(&slot_of(chunk)->refs, 1, memory_order_relaxed);
+}
+
+int chunk_slab_refs(const Chunk* chunk) {
+    return atomic_load_explicit(&slot_of(chunk)->refs, memory_order_acquire);
+}
+
+void chunk_slab_release(Chunk* chunk) {
+    if (!chunk) return;
+    SlabSlot* slot = slot_of(chunk);
+    if (atomic_fetch_sub_explicit(&slot->refs, 1, memory_order_acq_rel) != 1) return;
+    SlabCache* cache = &t_cache;
+    if (cache->count == CHUNK_SLAB_CACHE) flush(cache, CHUNK_SLAB_CACHE / 2);
+    cache->items[cache->count++] = slot->index;
+    atomic_fetch_sub_explicit(&g_live, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_frees, 1, memory_order_relaxed);
+}
+
+void chunk_slab_thread_flush(void) {
+    flush(&t_cache, 0);
+}
+
+ChunkSlabStats chunk_slab_stats(void) {
+    ChunkSlabStats s;
+    s.slabs = atomic_load(&g_slab_count);
+    s.live = atomic_load(&g_live);
+    s.slab_bytes = (size_t)s.slabs * CHUNK_SLAB_CHUNKS * sizeof(SlabSlot);
+    s.allocs = atomic_load(&g_allocs);
+    s.frees = atomic_load(&g_frees);
+    s.refills = atomic_load(&g_refills);
+    s.flushes = atomic_load(&g_flushes);
+    return s;
+}
+
+void chunk_slab_shutdown(void) {
+    if (atomic_load(&g_live) != 0) return;
+    int n = atomic_load(&g_slab_count);
+    for (int i = 0; i < n; i++) {
+        mem_free(MEM_TAG_WORLD, g_slabs[i]);
+        g_slabs[i] = NULL;
+    }
+    atomic_store(&g_slab_count, 0);
+    atomic_store(&g_free_head, SLAB_NONE);
+    t_cache.count = 0;
+}
@@ -0,0 +1,49 @@
+#include "chunk_view.h"
+
+#include <stdint.h>
+#include <string.h>
+
+static void copy_row(ChunkView* view, const World* world, int ly, int lz, int y, int z) {
+    int dst = chunk_view_index(-1, ly, lz);
+    int src_row = chunk_local_index(0, y & CHUNK_MASK, z & CHUNK_MASK);
+    int cy = y >> CHUNK_SHIFT;
+    int cz = z >> CHUNK_SHIFT;
+    int cx = view->x0 >> CHUNK_SHIFT;
+
+    const Chunk* c = world_chunk(world, cx, cy, cz);
+    memcpy(&view->blocks[dst + 1], &c->blocks[src_row], (size_t)view->size_x);
+    memcpy(&view->light[dst + 1], &c->light[src_row], (size_t)view->size_x);
+
+    if (view->x0 > 0) {
+        const Chunk* left = world_chunk(world, cx - 1, cy, cz);
+        view->blocks[dst] = left->blocks[src_row + CHUNK_MASK];
+        view->light[dst] = left->light[src_row + CHUNK_MASK];
+    }
+    if (view->size_x == CHUNK_SIZE && view->x0 + CHUNK_SIZE < world->w) {
+        const Chunk* right = world_chunk(world, cx + 1, cy, cz);
+        view->blocks[dst + CHUNK_SIZE + 1] = right->blocks[src_row];
+        view->light[dst + CHUNK_SIZE + 1] = right->light[src_row];
+    }
+}
+
+void chunk_view_gather(ChunkView* view, const World* world, int cx, int cy, int cz) {
+    view->x0 = cx << CHUNK_SHIFT;
+    view->y0 = cy << CHUNK_SHIFT;
+    view->z0 = cz << CHUNK_SHIFT;
+    view->size_x = world->w - view->x0 < CHUNK_SIZE ? world->w - view->x0 : CHUNK_SIZE;
+    view->size_y = world->h - view->y0 < CHUNK_SIZE ? world->h - view->y0 : CHUNK_SIZE;
+    view->size_z = world->d - view->z0 < CHUNK_SIZE ? world->d - view->z0 : CHUNK_SIZE;
+
+    memset(view->blocks, BLOCK_AIR, sizeof(view->blocks));
+    memset(view->light, CHUNK_VIEW_OUTSIDE_LIGHT, sizeof(view->light));
+
+    for (int ly = -1; ly <= view->size_y; ly++) {
+        int y = view->y0 + ly;
+        if (y < 0 || y >= world->h) continue;
+        for (int lz = -1; lz <= view->size_z; lz++) {
+            int z = view->z0 + lz;
+            if (z < 0 || z >= world->d) continue;
+            copy_row(view, world, ly, lz, y, z);
+        }
+    }
+}
@@ -31,6 +31,28 @@ PFNGLUNIFORM1IPROC glUniform1i_;
 PFNGLUNIFORM3FVPROC glUniform3fv_;
 PFNGLACTIVETEXTUREPROC glActiveTexture_;
 PFNGLGENERATEMIPMAPPROC glGenerateMipmap_;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor_;
+PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced_;
+PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArray_;
+PFNGLVERTEXATTRIB3FPROC glVertexAttrib3f_;
+PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData_;
+PFNGLMAPBUFFERRANGEPROC glMapBufferRange_;
+PFNGLUNMAPBUFFERPROC glUnmapBuffer_;
+PFNGLFENCESYNCPROC glFenceSync_;
+PFNGLCLIENTWAITSYNCPROC glClientWaitSync_;
+PFNGLDELETESYNCPROC glDeleteSync_;
+
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinary_;
+PFNGLPROGRAMBINARYPROC glProgramBinary_;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteri_;
+PFNGLMULTIDRAWARRAYSINDIRECTPROC glMultiDrawArraysIndirect_;
+PFNGLBUFFERSTORAGEPROC glBufferStorage_;
+PFNGLGENQUERIESPROC glGenQueries_;
+PFNGLDELETEQUERIESPROC glDeleteQueries_;
+PFNGLBEGINQUERYPROC glBeginQuery_;
+PFNGLENDQUERYPROC glEndQuery_;
+PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv_;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v_;
 
 static void* gl_get_proc(const char* name) {
     void* p = (void*)wglGetProcAddress(name);
@@ -77,6 +99,55 @@ bool gl_loader_init(void) {
     ok &= load_one((void**)&glUniform3fv_, "glUniform3fv");
     ok &= load_one((void**)&glActiveTexture_, "glActiveTexture");
     ok &= load_one((void**)&glGenerateMipmap_, "glGenerateMipmap");
+    ok &= load_one((void**)&glVertexAttribDivisor_, "glVertexAttribDivisor");
+    ok &= load_one((void**)&glDrawArraysInstanced_, "glDrawArraysInstanced");
+    ok &= load_one((void**)&glDisableVertexAttribArray_, "glDisableVertexAttribArray");
+    ok &= load_one((void**)&glVertexAttrib3f_, "glVertexAttrib3f");
+    ok &= load_one((void**)&glCopyBufferSubData_, "glCopyBufferSubData");
+    ok &= load_one((void**)&glMapBufferRange_, "glMapBufferRange");
+    ok &= load_one((void**)&glUnmapBuffer_, "glUnmapBuffer");
+    ok &= load_one((void**)&glFenceSync_, "glFenceSync");
+    ok &= load_one((void**)&glClientWaitSync_, "glClientWaitSync");
+    ok &= load_one((void**)&glDeleteSync_, "glDeleteSync");
+
+    load_one((void**)&glGetProgramBinary_, "glGetProgramBinary");
+    load_one((void**)&glProgramBinary_, "glProgramBinary");
+    load_one((void**)&glProgramParameteri_, "glProgramParameteri");
+    load_one((void**)&glMultiDrawArraysIndirect_, "glMultiDrawArraysIndirect");
+    load_one((void**)&glBufferStorage_, "glBufferStorage");
+    load_one((void**)&glGenQueries_, "glGenQueries");
+    load_one((void**)&glDeleteQueries_, "glDeleteQueries");
+    load_one((void**)&glBeginQuery_, "glBeginQuery");
+    load_one((void**)&glEndQuery_, "glEndQuery");
+    load_one((void**)&glGetQueryObjectiv_, "glGetQueryObjectiv");
+    load_one((void**)&glGetQueryObjectui64v_, "glGetQueryObjectui64v");
 
     return ok;
 }
+
+bool gl_has_program_binary(void) {
+    if (!glGetProgramBinary_ || !glProgramBinary_ || !glProgramParameteri_) return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+bool gl_has_multi_draw_indirect(void) {
+    if (!glMultiDrawArraysIndirect_) return false;
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    return major > 4 || (major == 4 && minor >= 3);
+}
+
+bool gl_has_buffer_storage(void) {
+    if (!glBufferStorage_) return false;
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    return major > 4 || (major == 4 && minor >= 4);
+}
+
+bool gl_has_timer_query(void) {
+    return glGenQueries_ && glDeleteQueries_ && glBeginQuery_ && glEndQuery_ && glGetQueryObjectiv_ && glGetQueryObjectui64v_;
+}
@@ -0,0 +1,170 @@
+#include "gl_state.h"
+
+#include "gl_loader.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+GlState g_gl_state;
+
+static int buffer_slot(uint32_t target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER: return 0;
+        case GL_COPY_READ_BUFFER: return 1;
+        case GL_COPY_WRITE_BUFFER: return 2;
+        case GL_DRAW_INDIRECT_BUFFER: return 3;
+        default: return -1;
+    }
+}
+
+void gl_state_reset(void) {
+    memset(&g_gl_state, 0, sizeof(g_gl_state));
+    g_gl_state.active_texture = GL_TEXTURE0;
+}
+
+GlStateStats gl_state_end_frame(void) {
+    GlStateStats s = g_gl_state.stats;
+    memset(&g_gl_state.stats, 0, sizeof(g_gl_state.stats));
+    return s;
+}
+
+void gl_state_use_program(uint32_t program) {
+    if (g_gl_state.program == program) {
+        g_gl_state.stats.skipped++;
+        return;
+    }
+    glUseProgram_(program);
+    g_gl_state.program = program;
+    g_gl_state.stats.issued++;
+}
+
+void gl_state_bind_vertex_array(uint32_t vao) {
+    if (g_gl_state.vertex_array == vao) {
+        g_gl_state.stats.skipped++;
+        return;
+    }
+    glBindVertexArray_(vao);
+    g_gl_state.vertex_array = vao;
+    g_gl_state.stats.issued++;
+}
+
+void gl_state_bind_buffer(uint32_t target, uint32_t buffer) {
+    int slot = buffer_slot(target);
+    if (slot >= 0 && g_gl_state.buffers[slot] == buffer) {
+        g_gl_state.stats.skipped++;
+        return;
+    }
+    glBindBuffer_(target, buffer);
+    if (slot >= 0) g_gl_state.buffers[slot] = buffer;
+    g_gl_state.stats.issued++;
+}
+
+void gl_state_active_texture(uint32_t unit) {
+    if (g_gl_state.active_texture == unit) {
+        g_gl_state.stats.skipped++;
+        return;
+    }
+    glActiveTexture_(unit);
+    g_gl_state.active_texture = unit;
+    g_gl_state.stats.issued++;
+}
+
+void gl_state_bind_texture_2d(uint32_t texture) {
+    uint32_t unit = g_gl_state.active_texture - GL_TEXTURE0;
+    if (unit < GL_STATE_TEXTURE_UNITS && g_gl_state.textures_2d[unit] == texture) {
+        g_gl_state.stats.skipped++;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (unit < GL_STATE_TEXTURE_UNITS) g_gl_state.textures_2d[unit] = texture;
+    g_gl_state.stats.issued++;
+}
+
+static bool uniform_changed(uint32_t program, int location, const float* v, int count) {
+    if (location < 0) return false;
+    for (int i = 0; i < g_gl_state.uniform_count; i++) {
+        GlUniformEntry* e = &g_gl_state.uniforms[i];
+        if (e->program != program || e->location != location) continue;
+        if (e->count == count && memcmp(e->v, v, (size_t)count * sizeof(float)) == 0) return false;
+        e->count = count;
+        memcpy(e->v, v, (size_t)count * sizeof(float));
+        return true;
+    }
+    if (g_gl_state.uniform_count < GL_STATE_MAX_UNIFORMS) {
+        GlUniformEntry* e = &g_gl_state.uniforms[g_gl_state.uniform_count++];
+        e->program = program;
+        e->location = location;
+        e->count = count;
+        memcpy(e->v, v, (size_t)count * sizeof(float));
+    }
+    return true;
+}
+
+void gl_state_uniform_1i(uint32_t program, int location, int v) {
+    float bits;
+    memcpy(&bits, &v, sizeof(bits));
+    if (!uniform_changed(program, location, &bits, 1)) {
+        g_gl_state.stats.skipped++;
+        return;
+    }
+    gl_state_use_program(program);
+    glUniform1i_(location, v);
+    g_gl_state.stats.issued++;
+}
+
+void gl_state_uniform_3fv(uint32_t program, int location, const float* v) {
+    if (!uniform_changed(program, location, v, 3)) {
+        g_gl_state.stats.skipped++;
+        return;
+    }
+    gl_state_use_program(program);
+    glUniform3fv_(location, 1, v);
+    g_gl_state.stats.issued++;
+}
+
+void gl_state_uniform_mat4(uint32_t program, int location, const float* m) {
+    if (!uniform_changed(program, location, m, 16)) {
+        g_gl_state.stats.skipped++;
+        return;
+    }
+    gl_state_use_program(program);
+    glUniformMatrix4fv_(location, 1, GL_FALSE, m);
+    g_gl_state.stats.issued++;
+}
+
+void gl_state_delete_program(uint32_t program) {
+    if (!program) return;
+    glDeleteProgram_(program);
+    if (g_gl_state.program == program) g_gl_state.program = 0;
+    int n = 0;
+    for (int i = 0; i < g_gl_state.uniform_count; i++) {
+        if (g_gl_state.uniforms[i].program != program) g_gl_state.uniforms[n++] = g_gl_state.uniforms[i];
+    }
+    g_gl_state.uniform_count = n;
+}
+
+void gl_state_delete_vertex_array(uint32_t vao) {
+    if (!vao) return;
+    GLuint a = (GLuint)vao;
+    glDeleteVertexArrays_(1, &a);
+    if (g_gl_state.vertex_array == vao) g_gl_state.vertex_array = 0;
+}
+
+void gl_state_delete_buffer(uint32_t buffer) {
+    if (!buffer) return;
+    GLuint b = (GLuint)buffer;
+    glDeleteBuffers_(1, &b);
+    for (int i = 0; i < GL_STATE_BUFFER_TARGETS; i++) {
+        if (g_gl_state.buffers[i] == buffer) g_gl_state.buffers[i] = 0;
+    }
+}
+
+void gl_state_delete_texture(uint32_t texture) {
+    if (!texture) return;
+    GLuint t = (GLuint)texture;
+    glDeleteTextures(1, &t);
+    for (int i = 0; i < GL_STATE_TEXTURE_UNITS; i++) {
+        if (g_gl_state.textures_2d[i] == texture) g_gl_state.textures_2d[i] = 0;
+    }
+}
@@ -0,0 +1,78 @@
+#include "governor.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#define GOVERNOR_OVER 1.10
+#define GOVERNOR_UNDER 0.75
+#define GOVERNOR_UP_CALM (GOVERNOR_WINDOW * 4)
+
+static void apply_level(Governor* g) {
+    float t = (float)g->level / (float)(GOVERNOR_LEVELS - 1);
+    const GovernorDesc* d = &g->desc;
+    g->stats.level = g->level;
+    g->stats.view_distance = d->max_view_distance + (d->min_view_distance - d->max_view_distance) * t;
+    g->stats.remesh_budget = d->max_remesh_budget - (int)((float)(d->max_remesh_budget - d->min_remesh_budget) * t + 0.5f);
+}
+
+void governor_init(Governor* g, GovernorDesc desc) {
+    memset(g, 0, sizeof(*g));
+    if (desc.target_ms <= 0.0) desc.target_ms = GOVERNOR_DEFAULT_TARGET_MS;
+    if (desc.min_remesh_budget < 1) desc.min_remesh_budget = 1;
+    if (desc.max_remesh_budget < desc.min_remesh_budget) desc.max_remesh_budget = desc.min_remesh_budget;
+    if (desc.max_view_distance < desc.min_view_distance) desc.max_view_distance = desc.min_view_distance;
+    g->desc = desc;
+    apply_level(g);
+}
+
+bool governor_frame(Governor* g, double frame_ms) {
+    g->samples[g->head] = frame_ms;
+    g->head = (g->head + 1) % GOVERNOR_WINDOW;
+    if (g->sample_count < GOVERNOR_WINDOW) g->sample_count++;
+
+    double sum = 0.0;
+    double worst = 0.0;
+    for (int i = 0; i < g->sample_count; i++) {
+        sum += g->samples[i];
+        if (g->samples[i] > worst) worst = g->samples[i];
+    }
+    g->stats.avg_ms = sum / (double)g->sample_count;
+    g->stats.worst_ms = worst;
+    if (g->sample_count < GOVERNOR_WINDOW) return false;
+
+    double target = g->desc.target_ms;
+    if (g->stats.avg_ms < target * GOVERNOR_UNDER) {
+        g->calm_frames++;
+    } else {
+        g->calm_frames = 0;
+    }
+
+    int level = g->level;
+    if (g->stats.avg_ms > target * GOVERNOR_OVER && level < GOVERNOR_LEVELS - 1) {
+        level++;
+        g->stats.downgrades++;
+    } else if (g->calm_frames >= GOVERNOR_UP_CALM && level > 0) {
+        level--;
+        g->stats.upgrades++;
+    }
+    if (level == g->level) return false;
+
+    g->level = level;
+    g->calm_frames = 0;
+    g->sample_count = 0;
+    g->head = 0;
+    apply_level(g);
+    return true;
+}
+
+float governor_view_distance(const Governor* g) {
+    return g->stats.view_distance;
+}
+
+int governor_remesh_budget(const Governor* g) {
+    return g->stats.remesh_budget;
+}
+
+const GovernorStats* governor_stats(const Governor* g) {
+    return &g->stats;
+}
@@ -5,6 +5,12 @@
 
 typedef struct AppWindow AppWindow;
 
+enum {
+    APP_KEY_SHIFT = 0x10,
+    APP_KEY_ESCAPE = 0x1B,
+    APP_KEY_SPACE = 0x20
+};
+
 typedef struct AppInput {
     bool keys[256];
     bool quit_requested;
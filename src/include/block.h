@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BLOCK_MAX_TYPES 256
+#define BLOCK_MAX_TILES 256
+#define BLOCK_FACE_COUNT 6
+
+#define ATLAS_TILE_PX 16
+#define ATLAS_TILES_PER_ROW 16
+
+typedef enum TileStyle {
+    TILE_NOISE = 0,
+    TILE_BANDED = 1
+} TileStyle;
+
+typedef struct TileDef {
+    TileStyle style;
+    uint32_t colors[3];
+    int base_tile;
+    int band_tile;
+    int band_rows;
+    uint32_t accent;
+} TileDef;
+
+typedef struct BlockDef {
+    const char* name;
+    bool solid;
+    bool opaque;
+    uint8_t emission;
+    uint8_t face_tiles[BLOCK_FACE_COUNT];
+} BlockDef;
+
+extern uint8_t g_block_solid[BLOCK_MAX_TYPES];
+extern uint8_t g_block_opaque[BLOCK_MAX_TYPES];
+extern uint8_t g_block_emission[BLOCK_MAX_TYPES];
+extern uint8_t g_block_face_tile[BLOCK_MAX_TYPES][BLOCK_FACE_COUNT];
+extern float g_tile_uv[BLOCK_MAX_TILES][4];
+
+void block_registry_init(void);
+int block_register_tile(const TileDef* def);
+bool block_register(uint8_t id, const BlockDef* def);
+void block_registry_compile(void);
+
+const BlockDef* block_def(uint8_t id);
+int block_tile_count(void);
+uint64_t block_registry_hash(void);
+uint32_t block_rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+uint32_t* block_build_atlas(int* out_w, int* out_h);
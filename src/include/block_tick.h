@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "world.h"
+#include "world_edit.h"
+
+#define BLOCK_TICK_RANDOM_PER_CHUNK 3
+#define BLOCK_TICK_DEFAULT_BUDGET 8192
+#define BLOCK_TICK_PARALLEL_MIN 2048
+#define BLOCK_TICK_BATCH 16
+#define BLOCK_TICK_MAX_THREADS 16
+#define BLOCK_TICK_FALL_DELAY 2
+#define BLOCK_TICK_GRASS_LIGHT 9
+
+typedef struct Thread Thread;
+typedef struct Mutex Mutex;
+typedef struct CondVar CondVar;
+
+typedef struct ScheduledTick {
+    uint64_t due;
+    uint16_t local;
+} ScheduledTick;
+
+typedef struct TickQueue {
+    ScheduledTick* items;
+    int count;
+    int cap;
+} TickQueue;
+
+typedef struct TickJob {
+    int chunk;
+    int first_scheduled;
+    int scheduled;
+    int random;
+    int first_edit;
+    int edit_count;
+} TickJob;
+
+typedef struct TickEdit {
+    BlockEdit edit;
+    uint8_t expect;
+} TickEdit;
+
+typedef struct BlockTickDesc {
+    uint64_t seed;
+    int random_per_chunk;
+    int budget;
+    int threads;
+} BlockTickDesc;
+
+typedef struct BlockTickStats {
+    uint64_t ticks;
+    uint64_t scheduled_run;
+    uint64_t random_run;
+    uint64_t changed;
+    uint64_t deferred;
+    int active_chunks;
+    int queued_chunks;
+    int pending;
+} BlockTickStats;
+
+typedef struct BlockTicker {
+    World* world;
+    uint64_t seed;
+    uint64_t tick;
+    int chunk_count;
+    int random_per_chunk;
+    int budget;
+    int thread_count;
+
+    TickQueue* queues;
+    int* queued;
+    int queued_count;
+    uint8_t* in_queued;
+
+    uint8_t* active;
+    int* active_list;
+    int* active_slot;
+    int active_count;
+    int cursor;
+
+    TickJob* jobs;
+    int job_count;
+    int job_cap;
+    uint16_t* due;
+    int due_count;
+    int due_cap;
+    TickEdit* edits;
+    int edit_cap;
+    BlockEdit* apply;
+    int apply_cap;
+
+    Mutex* lock;
+    CondVar* wake;
+    CondVar* idle;
+    Thread* workers[BLOCK_TICK_MAX_THREADS];
+    int worker_count;
+    int busy;
+    uint64_t generation;
+    bool quit;
+    int next_job;
+
+    BlockTickStats stats;
+} BlockTicker;
+
+bool block_tick_init(BlockTicker* bt, World* world, BlockTickDesc desc);
+void block_tick_shutdown(BlockTicker* bt);
+
+void block_tick_schedule(BlockTicker* bt, int x, int y, int z, int delay);
+void block_tick_notify(BlockTicker* bt, int x, int y, int z);
+void block_tick_refresh_chunk(BlockTicker* bt, int index);
+
+void block_tick_evaluate(BlockTicker* bt, uint64_t tick);
+int block_tick_apply(BlockTicker* bt);
+int block_tick_step(BlockTicker* bt, uint64_t tick);
+
+const BlockTickStats* block_tick_stats(const BlockTicker* bt);
@@ -8,6 +8,8 @@ typedef struct Vec3 {
     float z;
 } Vec3;
 
+typedef struct Mat4 Mat4;
+
 typedef struct Camera {
     Vec3 position_feet;
     Vec3 velocity;
@@ -20,3 +22,6 @@ void camera_init(Camera* cam);
 Vec3 camera_forward_xz(const Camera* cam);
 Vec3 camera_right_xz(const Camera* cam);
 void camera_apply_mouse(Camera* cam, int mouse_dx, int mouse_dy, float sensitivity);
+Camera camera_lerp(const Camera* a, const Camera* b, float t);
+Vec3 camera_eye(const Camera* cam);
+Mat4 camera_view_proj(const Camera* cam, int width, int height);
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "math4.h"
+#include "world.h"
+
+#define CHUNK_CACHE_PATH "world.cache"
+#define CHUNK_CACHE_PIN_RADIUS 24.0f
+#define CHUNK_CACHE_RECORD_BYTES (2 * CHUNK_VOLUME)
+#define CHUNK_CACHE_NO_SLOT UINT32_MAX
+
+typedef struct ChunkCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t writebacks;
+    uint64_t uniform_evictions;
+    uint64_t mesh_evictions;
+    uint64_t mesh_reloads;
+    size_t block_bytes;
+    size_t mesh_bytes;
+    int resident_chunks;
+    int resident_meshes;
+} ChunkCacheStats;
+
+typedef struct ChunkCache {
+    World* world;
+    FILE* backing;
+    char backing_path[512];
+    int chunk_count;
+    size_t block_budget;
+    size_t mesh_budget;
+    uint32_t clock;
+    Vec3 eye;
+
+    uint32_t* block_used;
+    uint32_t* mesh_used;
+    size_t* mesh_size;
+    uint8_t* state;
+    uint8_t* uniform;
+
+    uint32_t* slot;
+    uint8_t* held;
+    uint32_t* free_slots;
+    int free_count;
+    uint32_t* retired;
+    int retired_count;
+    uint32_t slot_count;
+    bool holding;
+
+    int* order;
+    uint64_t* keys;
+    Vec3* mins;
+    Vec3* maxs;
+    uint8_t* visible;
+
+    ChunkCacheStats stats;
+} ChunkCache;
+
+bool chunk_cache_init(ChunkCache* c, World* world, const char* backing_path, size_t block_budget, size_t mesh_budget);
+void chunk_cache_shutdown(ChunkCache* c);
+
+Chunk* chunk_cache_fault(ChunkCache* c, int index);
+void chunk_cache_touch(ChunkCache* c, int index);
+void chunk_cache_note_write(ChunkCache* c, int index);
+
+bool chunk_cache_hold_records(ChunkCache* c);
+void chunk_cache_release_records(ChunkCache* c);
+bool chunk_cache_stored_record(const ChunkCache* c, int index, uint32_t* out_slot, uint8_t out_uniform[2]);
+bool chunk_cache_read_record(FILE* f, uint32_t slot, Chunk* out);
+
+void chunk_cache_begin_frame(ChunkCache* c, Vec3 eye, Mat4 view_proj, float view_distance);
+void chunk_cache_set_mesh_bytes(ChunkCache* c, int index, size_t bytes);
+int chunk_cache_trim_meshes(ChunkCache* c, int* out_indices, int max_indices);
+int chunk_cache_take_mesh_reloads(ChunkCache* c, int* out_indices, int max_indices);
+int chunk_cache_trim_blocks(ChunkCache* c);
+
+const ChunkCacheStats* chunk_cache_stats(const ChunkCache* c);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "world.h"
+
+#define CHUNK_SLAB_SHIFT 6
+#define CHUNK_SLAB_CHUNKS (1 << CHUNK_SLAB_SHIFT)
+#define CHUNK_SLAB_MAX_SLABS 8192
+#define CHUNK_SLAB_CACHE 32
+
+typedef struct ChunkSlabStats {
+    int slabs;
+    int live;
+    size_t slab_bytes;
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t refills;
+    uint64_t flushes;
+} ChunkSlabStats;
+
+Chunk* chunk_slab_alloc(void);
+Chunk* chunk_slab_calloc(void);
+void chunk_slab_retain(Chunk* chunk);
+void chunk_slab_release(Chunk* chunk);
+int chunk_slab_refs(const Chunk* chunk);
+void chunk_slab_thread_flush(void);
+ChunkSlabStats chunk_slab_stats(void);
+void chunk_slab_shutdown(void);
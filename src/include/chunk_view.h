@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "world.h"
+
+#define CHUNK_VIEW_SIZE (CHUNK_SIZE + 2)
+#define CHUNK_VIEW_VOLUME (CHUNK_VIEW_SIZE * CHUNK_VIEW_SIZE * CHUNK_VIEW_SIZE)
+#define CHUNK_VIEW_STRIDE_X 1
+#define CHUNK_VIEW_STRIDE_Z CHUNK_VIEW_SIZE
+#define CHUNK_VIEW_STRIDE_Y (CHUNK_VIEW_SIZE * CHUNK_VIEW_SIZE)
+#define CHUNK_VIEW_OUTSIDE_LIGHT 0xF0
+
+typedef struct ChunkView {
+    int x0;
+    int y0;
+    int z0;
+    int size_x;
+    int size_y;
+    int size_z;
+    uint8_t blocks[CHUNK_VIEW_VOLUME];
+    uint8_t light[CHUNK_VIEW_VOLUME];
+} ChunkView;
+
+static inline int chunk_view_index(int lx, int ly, int lz) {
+    return (lx + 1) * CHUNK_VIEW_STRIDE_X + (lz + 1) * CHUNK_VIEW_STRIDE_Z + (ly + 1) * CHUNK_VIEW_STRIDE_Y;
+}
+
+void chunk_view_gather(ChunkView* view, const World* world, int cx, int cy, int cz);
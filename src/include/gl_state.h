@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GL_STATE_TEXTURE_UNITS 8
+#define GL_STATE_BUFFER_TARGETS 4
+#define GL_STATE_MAX_UNIFORMS 64
+
+typedef struct GlStateStats {
+    uint32_t issued;
+    uint32_t skipped;
+} GlStateStats;
+
+typedef struct GlUniformEntry {
+    uint32_t program;
+    int location;
+    int count;
+    float v[16];
+} GlUniformEntry;
+
+typedef struct GlState {
+    uint32_t program;
+    uint32_t vertex_array;
+    uint32_t buffers[GL_STATE_BUFFER_TARGETS];
+    uint32_t active_texture;
+    uint32_t textures_2d[GL_STATE_TEXTURE_UNITS];
+    GlUniformEntry uniforms[GL_STATE_MAX_UNIFORMS];
+    int uniform_count;
+    GlStateStats stats;
+} GlState;
+
+extern GlState g_gl_state;
+
+void gl_state_reset(void);
+GlStateStats gl_state_end_frame(void);
+
+void gl_state_use_program(uint32_t program);
+void gl_state_bind_vertex_array(uint32_t vao);
+void gl_state_bind_buffer(uint32_t target, uint32_t buffer);
+void gl_state_active_texture(uint32_t unit);
+void gl_state_bind_texture_2d(uint32_t texture);
+
+void gl_state_uniform_1i(uint32_t program, int location, int v);
+void gl_state_uniform_3fv(uint32_t program, int location, const float* v);
+void gl_state_uniform_mat4(uint32_t program, int location, const float* m);
+
+void gl_state_delete_program(uint32_t program);
+void gl_state_delete_vertex_array(uint32_t vao);
+void gl_state_delete_buffer(uint32_t buffer);
+void gl_state_delete_texture(uint32_t texture);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GOVERNOR_WINDOW 32
+#define GOVERNOR_LEVELS 5
+#define GOVERNOR_DEFAULT_TARGET_MS 16.6
+
+typedef struct GovernorDesc {
+    double target_ms;
+    float min_view_distance;
+    float max_view_distance;
+    int min_remesh_budget;
+    int max_remesh_budget;
+} GovernorDesc;
+
+typedef struct GovernorStats {
+    double avg_ms;
+    double worst_ms;
+    int level;
+    float view_distance;
+    int remesh_budget;
+    uint32_t downgrades;
+    uint32_t upgrades;
+} GovernorStats;
+
+typedef struct Governor {
+    GovernorDesc desc;
+    double samples[GOVERNOR_WINDOW];
+    int sample_count;
+    int head;
+    int level;
+    int calm_frames;
+    GovernorStats stats;
+} Governor;
+
+void governor_init(Governor* g, GovernorDesc desc);
+bool governor_frame(Governor* g, double frame_ms);
+float governor_view_distance(const Governor* g);
+int governor_remesh_budget(const Governor* g);
+const GovernorStats* governor_stats(const Governor* g);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "world.h"
+
+#define LIGHT_MAX 15
+
+uint8_t light_get_sky(const World* world, int x, int y, int z);
+uint8_t light_get_block(const World* world, int x, int y, int z);
+
+void light_compute_world(World* world);
+void light_update_block(World* world, int x, int y, int z, BlockType old_t, BlockType new_t);
+void light_update_blocks(World* world, const BlockPos* cells, size_t count);
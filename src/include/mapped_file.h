@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct MappedFile {
+    void* data;
+    size_t size;
+    void* file_handle;
+    void* map_handle;
+    int fd;
+} MappedFile;
+
+bool mapped_file_open(MappedFile* out_file, const char* path);
+void mapped_file_close(MappedFile* file);
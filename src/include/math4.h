@@ -1,7 +1,25 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "camera.h"
 
+#if !defined(MATH4_NO_SIMD)
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define MATH4_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MATH4_NEON 1
+#endif
+#endif
+
+typedef struct Vec4 {
+    float x;
+    float y;
+    float z;
+    float w;
+} Vec4;
+
 typedef struct Mat4 {
     float m[16];
 } Mat4;
@@ -14,8 +32,25 @@ Vec3 vec3_cross(Vec3 a, Vec3 b);
 float vec3_len(Vec3 v);
 Vec3 vec3_norm(Vec3 v);
 
+void vec3_add_p(Vec3* out, const Vec3* a, const Vec3* b);
+void vec3_sub_p(Vec3* out, const Vec3* a, const Vec3* b);
+void vec3_scale_p(Vec3* out, const Vec3* v, float s);
+void vec3_madd_p(Vec3* io, const Vec3* v, float s);
+void vec3_cross_p(Vec3* out, const Vec3* a, const Vec3* b);
+void vec3_norm_p(Vec3* io);
+
 Mat4 mat4_identity(void);
 Mat4 mat4_mul(Mat4 a, Mat4 b);
 Mat4 mat4_perspective(float fov_y_radians, float aspect, float z_near, float z_far);
 Mat4 mat4_look(Vec3 eye, Vec3 forward, Vec3 up);
 
+void mat4_mul_p(Mat4* out, const Mat4* a, const Mat4* b);
+Vec4 mat4_mul_vec4(const Mat4* m, Vec4 v);
+void mat4_transform_points(const Mat4* m, const Vec3* points, Vec4* out, size_t count);
+void mat4_frustum_planes(const Mat4* view_proj, Vec4 out_planes[6]);
+size_t aabb_cull_planes(const Vec4 planes[6], const Vec3* mins, const Vec3* maxs, uint8_t* out_visible, size_t count);
+
+void mat4_mul_ref(Mat4* out, const Mat4* a, const Mat4* b);
+Vec4 mat4_mul_vec4_ref(const Mat4* m, Vec4 v);
+void mat4_transform_points_ref(const Mat4* m, const Vec3* points, Vec4* out, size_t count);
+size_t aabb_cull_planes_ref(const Vec4 planes[6], const Vec3* mins, const Vec3* maxs, uint8_t* out_visible, size_t count);
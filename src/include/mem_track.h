@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum MemTag {
+    MEM_TAG_WORLD = 0,
+    MEM_TAG_MESH,
+    MEM_TAG_SCRATCH,
+    MEM_TAG_TEXTURE,
+    MEM_TAG_GPU_MIRROR,
+    MEM_TAG_COUNT
+} MemTag;
+
+typedef struct MemTagStats {
+    size_t current_bytes;
+    size_t peak_bytes;
+    uint64_t alloc_count;
+    uint64_t realloc_count;
+    uint64_t free_count;
+    size_t budget_bytes;
+} MemTagStats;
+
+void* mem_alloc(MemTag tag, size_t bytes);
+void* mem_calloc(MemTag tag, size_t count, size_t size);
+void* mem_realloc(MemTag tag, void* ptr, size_t bytes);
+void mem_free(MemTag tag, void* ptr);
+
+void mem_set_budget(MemTag tag, size_t bytes);
+bool mem_over_budget(MemTag tag);
+MemTagStats mem_tag_stats(MemTag tag);
+size_t mem_total_bytes(void);
+void mem_reset_peaks(void);
+const char* mem_tag_name(MemTag tag);
+void mem_log_report(const char* label);
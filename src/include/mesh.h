@@ -1,11 +1,15 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+#define MESH_VERTEX_FLOATS 10
+
 typedef struct Mesh {
     float* vertices;
     size_t vertex_count;
+    bool external;
 } Mesh;
 
 void mesh_free(Mesh* mesh);
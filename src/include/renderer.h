@@ -5,6 +5,67 @@
 
 #include "math4.h"
 #include "mesh.h"
+#include "shader_cache.h"
+#include "stream_buffer.h"
+
+#include <stddef.h>
+
+typedef struct ChunkDrawCommand {
+    uint32_t count;
+    uint32_t instance_count;
+    uint32_t first;
+    uint32_t base_instance;
+} ChunkDrawCommand;
+
+typedef struct VertexRange {
+    size_t first;
+    size_t count;
+} VertexRange;
+
+typedef struct ChunkPool {
+    uint32_t program;
+    uint32_t vao;
+    uint32_t vbo;
+    uint32_t origin_vbo;
+    int u_view_proj;
+    bool multi_draw;
+
+    size_t vertex_capacity;
+    VertexRange* free_ranges;
+    size_t free_count;
+    size_t free_cap;
+
+    int slot_count;
+    VertexRange* slots;
+    size_t* slot_capacity;
+    Vec4* origins;
+    Vec3* mins;
+    Vec3* maxs;
+    uint8_t* visible;
+    ChunkDrawCommand* commands;
+    size_t draw_count;
+
+    Vec3 view_eye;
+    float view_distance;
+} ChunkPool;
+
+#define RENDER_TIMER_LATENCY 4
+
+typedef enum RenderPass {
+    RENDER_PASS_WORLD = 0,
+    RENDER_PASS_VIEWMODEL,
+    RENDER_PASS_COUNT
+} RenderPass;
+
+typedef struct RenderStats {
+    uint32_t draw_calls;
+    uint64_t triangles;
+    uint64_t upload_bytes;
+    uint32_t state_calls;
+    uint32_t state_skipped;
+    uint32_t chunks_drawn;
+    double gpu_ms[RENDER_PASS_COUNT];
+} RenderStats;
 
 typedef struct Renderer {
     uint32_t program;
@@ -13,10 +74,49 @@ typedef struct Renderer {
     uint32_t texture_atlas;
     int u_mvp;
     int u_light_dir;
+
+    uint32_t instanced_program;
+    int u_inst_view_proj;
+
+    StreamBuffer stream;
+
+    bool timers_enabled;
+    uint32_t timer_queries[RENDER_TIMER_LATENCY][RENDER_PASS_COUNT];
+    bool timer_pending[RENDER_TIMER_LATENCY][RENDER_PASS_COUNT];
+    int timer_frame;
+    int active_pass;
+    double gpu_ms[RENDER_PASS_COUNT];
+    RenderStats frame_stats;
+    RenderStats last_stats;
+
+    ChunkPool chunks;
+
+    ShaderCacheStats shader_stats;
 } Renderer;
 
+typedef struct GpuMesh {
+    uint32_t vao;
+    uint32_t vbo;
+    size_t vertex_count;
+} GpuMesh;
+
 bool renderer_init(Renderer* r);
 void renderer_shutdown(Renderer* r);
 void renderer_resize(int width, int height);
 void renderer_draw_mesh(Renderer* r, const Mesh* mesh, Mat4 mvp);
 
+bool renderer_upload_mesh(Renderer* r, const Mesh* mesh, GpuMesh* out_mesh);
+void renderer_free_mesh(GpuMesh* mesh);
+void renderer_draw_instanced(Renderer* r, const GpuMesh* mesh, const Mat4* models, size_t count, Mat4 view_proj);
+
+bool renderer_chunks_init(Renderer* r, int slot_count);
+bool renderer_chunk_upload(Renderer* r, int slot, const Mesh* mesh, Vec3 origin);
+void renderer_chunk_clear(Renderer* r, int slot);
+size_t renderer_chunk_bytes(const Renderer* r, int slot);
+void renderer_chunks_set_view_distance(Renderer* r, Vec3 eye, float distance);
+void renderer_draw_chunks(Renderer* r, Mat4 view_proj);
+void renderer_begin_pass(Renderer* r, RenderPass pass);
+void renderer_end_pass(Renderer* r);
+void renderer_end_frame(Renderer* r);
+const RenderStats* renderer_stats(const Renderer* r);
+const char* renderer_pass_name(RenderPass pass);
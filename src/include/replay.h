@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "app.h"
+#include "camera.h"
+#include "world.h"
+
+typedef struct ReplayWriter {
+    FILE* file;
+    AppInput prev;
+    uint32_t frame_count;
+} ReplayWriter;
+
+typedef struct ReplayReader {
+    uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint64_t seed;
+    uint32_t generator;
+    int tick_hz;
+    uint32_t frame_count;
+    uint32_t frame;
+    AppInput input;
+} ReplayReader;
+
+bool replay_writer_open(ReplayWriter* w, const char* path, uint64_t seed, uint32_t generator, int tick_hz);
+bool replay_writer_frame(ReplayWriter* w, const AppInput* in, double dt);
+bool replay_writer_close(ReplayWriter* w);
+
+bool replay_reader_open(ReplayReader* r, const char* path);
+bool replay_reader_next(ReplayReader* r, AppInput* out_input, double* out_dt);
+void replay_reader_close(ReplayReader* r);
+
+uint64_t replay_state_hash(const World* world, const Camera* cam);
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SHADER_CACHE_DIR "shader_cache"
+
+typedef struct ShaderCacheStats {
+    int programs_built;
+    int cache_hits;
+    int cache_writes;
+} ShaderCacheStats;
+
+uint32_t shader_cache_build_program(const char* name, const char* vs_src, const char* fs_src, ShaderCacheStats* io_stats);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "app.h"
+#include "camera.h"
+#include "world.h"
+
+#define SIM_DEFAULT_TICK_HZ 60
+#define SIM_MAX_TICKS_PER_UPDATE 8
+
+typedef struct Thread Thread;
+typedef struct Mutex Mutex;
+typedef struct BlockTicker BlockTicker;
+
+typedef double (*SimClockFn)(void);
+
+typedef struct SimDesc {
+    World* world;
+    Camera camera;
+    int tick_hz;
+    bool threaded;
+    SimClockFn clock;
+    BlockTicker* ticks;
+} SimDesc;
+
+typedef struct Sim {
+    World* world;
+    double tick_dt;
+    double accumulator;
+    uint64_t tick;
+
+    Camera prev;
+    Camera curr;
+
+    bool keys[256];
+    int pending_mouse_dx;
+    int pending_mouse_dy;
+
+    bool threaded;
+    bool running;
+    SimClockFn clock;
+    double curr_time;
+    Thread* thread;
+    Mutex* lock;
+
+    BlockTicker* ticks;
+    Mutex* world_lock;
+} Sim;
+
+bool sim_init(Sim* sim, SimDesc desc);
+void sim_shutdown(Sim* sim);
+
+void sim_submit_input(Sim* sim, const AppInput* in);
+int sim_update(Sim* sim, double frame_dt);
+Camera sim_camera(Sim* sim, float* out_alpha);
+
+void sim_step_player(const World* world, Camera* cam, const AppInput* in, float dt);
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "math4.h"
+
+#if defined(MATH4_SSE)
+#include <xmmintrin.h>
+#elif defined(MATH4_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(MATH4_SSE)
+typedef __m128 F4;
+static inline F4 f4_set1(float v) { return _mm_set1_ps(v); }
+static inline F4 f4_set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+static inline F4 f4_add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+static inline F4 f4_sub(F4 a, F4 b) { return _mm_sub_ps(a, b); }
+static inline F4 f4_mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+static inline F4 f4_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void f4_store(float* p, F4 v) { _mm_storeu_ps(p, v); }
+static inline int f4_ge(F4 a, F4 b) { return _mm_movemask_ps(_mm_cmpge_ps(a, b)); }
+static inline int f4_gt(F4 a, F4 b) { return _mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+static inline int f4_lt(F4 a, F4 b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+#elif defined(MATH4_NEON)
+typedef float32x4_t F4;
+static inline F4 f4_set1(float v) { return vdupq_n_f32(v); }
+static inline F4 f4_set(float a, float b, float c, float d) {
+    float t[4] = { a, b, c, d };
+    return vld1q_f32(t);
+}
+static inline F4 f4_add(F4 a, F4 b) { return vaddq_f32(a, b); }
+static inline F4 f4_sub(F4 a, F4 b) { return vsubq_f32(a, b); }
+static inline F4 f4_mul(F4 a, F4 b) { return vmulq_f32(a, b); }
+static inline F4 f4_load(const float* p) { return vld1q_f32(p); }
+static inline void f4_store(float* p, F4 v) { vst1q_f32(p, v); }
+static inline int u4_bits(uint32x4_t m) {
+    static const uint32_t weights[4] = { 1, 2, 4, 8 };
+    uint32x4_t b = vandq_u32(m, vld1q_u32(weights));
+    uint32x2_t s = vadd_u32(vget_low_u32(b), vget_high_u32(b));
+    return (int)(vget_lane_u32(s, 0) + vget_lane_u32(s, 1));
+}
+static inline int f4_ge(F4 a, F4 b) { return u4_bits(vcgeq_f32(a, b)); }
+static inline int f4_gt(F4 a, F4 b) { return u4_bits(vcgtq_f32(a, b)); }
+static inline int f4_lt(F4 a, F4 b) { return u4_bits(vcltq_f32(a, b)); }
+#else
+typedef struct F4 {
+    float v[4];
+} F4;
+static inline F4 f4_set1(float v) { F4 r = { { v, v, v, v } }; return r; }
+static inline F4 f4_set(float a, float b, float c, float d) { F4 r = { { a, b, c, d } }; return r; }
+static inline F4 f4_add(F4 a, F4 b) {
+    for (int i = 0; i < 4; i++) a.v[i] += b.v[i];
+    return a;
+}
+static inline F4 f4_sub(F4 a, F4 b) {
+    for (int i = 0; i < 4; i++) a.v[i] -= b.v[i];
+    return a;
+}
+static inline F4 f4_mul(F4 a, F4 b) {
+    for (int i = 0; i < 4; i++) a.v[i] *= b.v[i];
+    return a;
+}
+static inline F4 f4_load(const float* p) { F4 r; memcpy(r.v, p, sizeof(r.v)); return r; }
+static inline void f4_store(float* p, F4 v) { memcpy(p, v.v, sizeof(v.v)); }
+static inline int f4_ge(F4 a, F4 b) {
+    int m = 0;
+    for (int i = 0; i < 4; i++) m |= (a.v[i] >= b.v[i]) << i;
+    return m;
+}
+static inline int f4_gt(F4 a, F4 b) {
+    int m = 0;
+    for (int i = 0; i < 4; i++) m |= (a.v[i] > b.v[i]) << i;
+    return m;
+}
+static inline int f4_lt(F4 a, F4 b) {
+    int m = 0;
+    for (int i = 0; i < 4; i++) m |= (a.v[i] < b.v[i]) << i;
+    return m;
+}
+#endif
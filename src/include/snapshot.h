@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mapped_file.h"
+#include "mesh.h"
+#include "world.h"
+
+#define SNAPSHOT_PATH "world.snap"
+
+typedef struct Snapshot {
+    MappedFile file;
+} Snapshot;
+
+uint64_t snapshot_key(int w, int h, int d, uint64_t seed, uint32_t generator);
+bool snapshot_load(Snapshot* snap, const char* path, uint64_t key, World* out_world, Mesh** out_meshes);
+bool snapshot_save(const char* path, uint64_t key, const World* world, const Mesh* meshes);
+void snapshot_close(Snapshot* snap);
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SOFT_TILE_SIZE 32
+#define SOFT_MAX_THREADS 64
+#define SOFT_DEFAULT_WIDTH 640
+#define SOFT_DEFAULT_HEIGHT 360
+
+typedef struct SoftStats {
+    uint64_t triangles_in;
+    uint64_t triangles_binned;
+    uint64_t tile_refs;
+    uint64_t pixels_written;
+} SoftStats;
+
+void soft_renderer_set_threads(int count);
+void soft_renderer_clear(uint32_t rgba);
+const uint32_t* soft_renderer_pixels(int* out_w, int* out_h, int* out_stride);
+bool soft_renderer_write_ppm(const char* path);
+SoftStats soft_renderer_take_stats(void);
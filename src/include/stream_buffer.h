@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define STREAM_BUFFER_DEFAULT_SIZE (16u * 1024u * 1024u)
+#define STREAM_BUFFER_MAX_FENCES 16
+
+typedef struct StreamFence {
+    void* sync;
+    size_t bytes;
+} StreamFence;
+
+typedef struct StreamBufferStats {
+    size_t bytes_written;
+    int fence_waits;
+} StreamBufferStats;
+
+typedef struct StreamBuffer {
+    uint32_t buffer;
+    uint8_t* mapped;
+    bool persistent;
+    size_t size;
+    size_t head;
+    size_t used;
+    size_t pending;
+    StreamFence fences[STREAM_BUFFER_MAX_FENCES];
+    int fence_first;
+    int fence_count;
+    StreamBufferStats stats;
+} StreamBuffer;
+
+bool stream_buffer_init(StreamBuffer* sb, size_t size);
+void stream_buffer_shutdown(StreamBuffer* sb);
+bool stream_buffer_write(StreamBuffer* sb, const void* data, size_t bytes, size_t align, size_t* out_offset);
+void stream_buffer_end_frame(StreamBuffer* sb);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "world.h"
+
+#define TERRAIN_CELL_X 4
+#define TERRAIN_CELL_Y 8
+#define TERRAIN_CELL_Z 4
+
+float terrain_density(uint64_t seed, float x, float y, float z);
+
+void terrain_fill_chunk(World* world, int cx, int cy, int cz, uint64_t seed);
+void terrain_fill_chunk_ref(World* world, int cx, int cy, int cz, uint64_t seed);
+void terrain_paint_surface(World* world);
+
+void world_generate_terrain(World* world, uint64_t seed);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdbool.h>
+
+typedef struct Thread Thread;
+typedef struct Mutex Mutex;
+typedef struct CondVar CondVar;
+
+typedef void (*ThreadFn)(void* user);
+
+bool thread_create(Thread** out_thread, ThreadFn fn, void* user);
+void thread_join(Thread* thread);
+void thread_sleep_ms(int ms);
+int thread_hardware_concurrency(void);
+
+bool mutex_create(Mutex** out_mutex);
+void mutex_destroy(Mutex* mutex);
+void mutex_lock(Mutex* mutex);
+void mutex_unlock(Mutex* mutex);
+
+bool condvar_create(CondVar** out_cv);
+void condvar_destroy(CondVar* cv);
+void condvar_wait(CondVar* cv, Mutex* mutex);
+void condvar_signal(CondVar* cv);
+void condvar_broadcast(CondVar* cv);
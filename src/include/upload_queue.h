@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "math4.h"
+#include "mesh.h"
+#include "renderer.h"
+
+#define UPLOAD_QUEUE_DEFAULT_BYTES (2u * 1024u * 1024u)
+#define UPLOAD_QUEUE_DEFAULT_MS 2.0
+
+typedef double (*UploadClockFn)(void);
+
+typedef struct UploadQueueStats {
+    uint64_t submitted;
+    uint64_t superseded;
+    uint64_t uploaded;
+    uint64_t uploaded_bytes;
+    uint64_t deferred_frames;
+    int pending;
+} UploadQueueStats;
+
+typedef struct UploadQueue {
+    int slot_count;
+    Mesh* meshes;
+    Vec3* origins;
+    uint8_t* queued;
+    int* pending;
+    int pending_count;
+
+    int* order;
+    float* keys;
+    Vec3* mins;
+    Vec3* maxs;
+    uint8_t* visible;
+
+    size_t byte_budget;
+    double time_budget_ms;
+    UploadClockFn clock;
+    UploadQueueStats stats;
+} UploadQueue;
+
+bool upload_queue_init(UploadQueue* q, int slot_count, size_t byte_budget, double time_budget_ms, UploadClockFn clock);
+void upload_queue_shutdown(UploadQueue* q);
+void upload_queue_submit(UploadQueue* q, int slot, Mesh mesh, Vec3 origin);
+void upload_queue_cancel(UploadQueue* q, int slot);
+int upload_queue_flush(UploadQueue* q, Renderer* r, Vec3 eye, Mat4 view_proj);
+const UploadQueueStats* upload_queue_stats(const UploadQueue* q);
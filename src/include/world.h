@@ -3,29 +3,128 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "camera.h"
 #include "mesh.h"
 
+#define CHUNK_SHIFT 4
+#define CHUNK_SIZE (1 << CHUNK_SHIFT)
+#define CHUNK_MASK (CHUNK_SIZE - 1)
+#define CHUNK_VOLUME (CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE)
+
 typedef enum BlockType {
     BLOCK_AIR = 0,
     BLOCK_GRASS = 1,
     BLOCK_DIRT = 2,
-    BLOCK_STONE = 3
+    BLOCK_STONE = 3,
+    BLOCK_LAMP = 4,
+    BLOCK_SAND = 5
 } BlockType;
 
+typedef enum WorldGenerator {
+    WORLD_GEN_FLAT = 0,
+    WORLD_GEN_TERRAIN = 1
+} WorldGenerator;
+
+typedef enum HeightmapKind {
+    HEIGHTMAP_SOLID = 0,
+    HEIGHTMAP_OPAQUE,
+    HEIGHTMAP_KIND_COUNT
+} HeightmapKind;
+
+#define CHUNK_COLUMN_AREA (CHUNK_SIZE * CHUNK_SIZE)
+
+typedef struct ChunkColumnHeights {
+    int16_t top[HEIGHTMAP_KIND_COUNT][CHUNK_COLUMN_AREA];
+} ChunkColumnHeights;
+
+typedef struct BlockPos {
+    int x;
+    int y;
+    int z;
+} BlockPos;
+
+typedef struct Chunk {
+    uint8_t blocks[CHUNK_VOLUME];
+    uint8_t light[CHUNK_VOLUME];
+    bool dirty;
+} Chunk;
+
+typedef struct ChunkCache ChunkCache;
+
 typedef struct World {
     int w;
     int h;
     int d;
-    uint8_t* blocks;
+    int chunks_x;
+    int chunks_y;
+    int chunks_z;
+    Chunk** chunks;
+    ChunkColumnHeights* columns;
+    ChunkCache* cache;
+    bool chunks_external;
+    bool light_ready;
 } World;
 
+static inline int chunk_local_index(int lx, int ly, int lz) {
+    return lx | (lz << CHUNK_SHIFT) | (ly << (2 * CHUNK_SHIFT));
+}
+
+Chunk* chunk_cache_fault(ChunkCache* cache, int index);
+
+static inline Chunk* world_chunk_at(const World* world, int index) {
+    Chunk* chunk = world->chunks[index];
+    if (!chunk && world->cache) return chunk_cache_fault(world->cache, index);
+    return chunk;
+}
+
+static inline Chunk* world_chunk(const World* world, int cx, int cy, int cz) {
+    return world_chunk_at(world, cx + world->chunks_x * (cz + world->chunks_z * cy));
+}
+
+static inline int16_t* world_column_top(const World* world, int x, int z, HeightmapKind kind) {
+    ChunkColumnHeights* col = &world->columns[(x >> CHUNK_SHIFT) + world->chunks_x * (z >> CHUNK_SHIFT)];
+    return &col->top[kind][(x & CHUNK_MASK) | ((z & CHUNK_MASK) << CHUNK_SHIFT)];
+}
+
+static inline int world_chunk_count(const World* world) {
+    return world->chunks_x * world->chunks_y * world->chunks_z;
+}
+
+static inline void world_chunk_coords(const World* world, int index, int* out_cx, int* out_cy, int* out_cz) {
+    *out_cx = index % world->chunks_x;
+    *out_cz = (index / world->chunks_x) % world->chunks_z;
+    *out_cy = index / (world->chunks_x * world->chunks_z);
+}
+
+static inline bool world_in_bounds(const World* world, int x, int y, int z) {
+    return x >= 0 && x < world->w && y >= 0 && y < world->h && z >= 0 && z < world->d;
+}
+
 bool world_init(World* world, int w, int h, int d);
 void world_shutdown(World* world);
+bool world_adopt_external_chunks(World* world);
+Chunk* world_chunk_write(World* world, int cx, int cy, int cz);
 
 BlockType world_get(const World* world, int x, int y, int z);
 void world_set(World* world, int x, int y, int z, BlockType t);
 
 void world_generate_flat(World* world);
+void world_generate(World* world, WorldGenerator generator, uint64_t seed);
+bool world_alloc_heightmaps(World* world);
+void world_build_heightmaps(World* world);
+void world_heightmap_update(World* world, int x, int y, int z, BlockType t);
+int world_height(const World* world, int x, int z, HeightmapKind kind);
+Vec3 world_spawn_point(const World* world);
 bool world_is_solid(BlockType t);
+bool world_is_opaque(BlockType t);
+uint8_t world_light_emission(BlockType t);
+
+void world_mark_dirty(World* world, int x, int y, int z);
+void world_mark_chunk_dirty(World* world, int index);
+bool world_clear_dirty(World* world);
+int world_take_dirty_chunks(World* world, int* out_indices, int max_indices);
 
 Mesh world_build_mesh(const World* world);
+Mesh world_build_chunk_mesh(const World* world, int cx, int cy, int cz);
+Mesh* world_build_chunk_meshes(const World* world);
+void world_free_chunk_meshes(Mesh* meshes, int count);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "world.h"
+
+typedef struct BlockEdit {
+    int x;
+    int y;
+    int z;
+    BlockType type;
+} BlockEdit;
+
+typedef struct BlockVolume {
+    int w;
+    int h;
+    int d;
+    uint8_t* blocks;
+} BlockVolume;
+
+static inline size_t block_volume_index(const BlockVolume* v, int x, int y, int z) {
+    return (size_t)x + (size_t)v->w * ((size_t)z + (size_t)v->d * (size_t)y);
+}
+
+int world_fill_box(World* world, int x0, int y0, int z0, int x1, int y1, int z1, BlockType t);
+int world_fill_sphere(World* world, float cx, float cy, float cz, float radius, BlockType t);
+int world_carve_sphere(World* world, float cx, float cy, float cz, float radius);
+int world_apply_edits(World* world, const BlockEdit* edits, size_t count);
+
+bool world_copy_volume(const World* world, int x0, int y0, int z0, int w, int h, int d, BlockVolume* out_volume);
+int world_paste_volume(World* world, const BlockVolume* volume, int x0, int y0, int z0, bool skip_air);
+void block_volume_free(BlockVolume* volume);
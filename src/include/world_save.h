@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mesh.h"
+#include "world.h"
+#include "world_snapshot.h"
+
+#define WORLD_SAVE_PATH "world.save"
+#define WORLD_SAVE_MAX_RECORD (4 * CHUNK_VOLUME)
+
+typedef struct Thread Thread;
+
+typedef struct WorldSaveStats {
+    int chunks;
+    uint64_t raw_bytes;
+    uint64_t file_bytes;
+    uint64_t mesh_bytes;
+} WorldSaveStats;
+
+typedef struct WorldSaveJob {
+    Thread* thread;
+    WorldSnapshot snap;
+    char path[512];
+    atomic_bool done;
+    bool ok;
+    WorldSaveStats stats;
+} WorldSaveJob;
+
+size_t world_save_encode_chunk(const Chunk* c, uint8_t* out);
+bool world_save_decode_chunk(const uint8_t* in, size_t size, Chunk* out);
+
+bool world_save_write(const World* world, const Mesh* meshes, const char* path, WorldSaveStats* out_stats);
+bool world_save_read(World* world, const char* path, Mesh** out_meshes);
+
+bool world_save_start(WorldSaveJob* job, World* world, const char* path);
+bool world_save_poll(WorldSaveJob* job);
+bool world_save_finish(WorldSaveJob* job);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "world.h"
+
+typedef struct WorldSnapshot {
+    World view;
+    ChunkCache* cache;
+    FILE* records;
+    uint32_t* slots;
+    uint8_t* uniform;
+} WorldSnapshot;
+
+bool world_snapshot_take(WorldSnapshot* snap, World* world);
+void world_snapshot_release(WorldSnapshot* snap);
+const Chunk* world_snapshot_chunk(const WorldSnapshot* snap, int index, Chunk* scratch);
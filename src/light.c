@@ -0,0 +1,263 @@
+#include "light.h"
+
+#include "mem_track.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    CHANNEL_BLOCK = 0,
+    CHANNEL_SKY = 1
+};
+
+enum { DIR_DOWN = 3 };
+
+static const int k_dirs[6][3] = {
+    { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+};
+
+typedef struct LightNode {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    uint8_t level;
+} LightNode;
+
+typedef struct LightQueue {
+    LightNode* data;
+    size_t head;
+    size_t count;
+    size_t cap;
+} LightQueue;
+
+static void lq_push(LightQueue* q, int x, int y, int z, uint8_t level) {
+    if (q->count + 1 > q->cap) {
+        size_t new_cap = q->cap ? q->cap * 2 : 1024;
+        LightNode* p = (LightNode*)mem_realloc(MEM_TAG_SCRATCH, q->data, new_cap * sizeof(LightNode));
+        if (!p) return;
+        q->data = p;
+        q->cap = new_cap;
+    }
+    LightNode n = { (int16_t)x, (int16_t)y, (int16_t)z, level };
+    q->data[q->count++] = n;
+}
+
+static bool lq_pop(LightQueue* q, LightNode* out) {
+    if (q->head == q->count) {
+        q->head = 0;
+        q->count = 0;
+        return false;
+    }
+    *out = q->data[q->head++];
+    return true;
+}
+
+static void lq_free(LightQueue* q) {
+    mem_free(MEM_TAG_SCRATCH, q->data);
+    memset(q, 0, sizeof(*q));
+}
+
+static uint8_t* light_cell(const World* world, int x, int y, int z) {
+    Chunk* c = world_chunk(world, x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+    return &c->light[chunk_local_index(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)];
+}
+
+static uint8_t* light_cell_write(World* world, int x, int y, int z) {
+    Chunk* c = world_chunk_write(world, x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+    return &c->light[chunk_local_index(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)];
+}
+
+static uint8_t get_channel(uint8_t packed, int ch) {
+    return ch == CHANNEL_SKY ? (uint8_t)(packed >> 4) : (uint8_t)(packed & 0x0F);
+}
+
+static void set_channel(uint8_t* packed, int ch, uint8_t v) {
+    if (ch == CHANNEL_SKY) {
+        *packed = (uint8_t)((*packed & 0x0F) | (v << 4));
+    } else {
+        *packed = (uint8_t)((*packed & 0xF0) | (v & 0x0F));
+    }
+}
+
+static void write_light(World* world, int x, int y, int z, int ch, uint8_t v) {
+    set_channel(light_cell_write(world, x, y, z), ch, v);
+    world_mark_dirty(world, x, y, z);
+}
+
+uint8_t light_get_sky(const World* world, int x, int y, int z) {
+    if (!world || !world->chunks) return LIGHT_MAX;
+    if (!world_in_bounds(world, x, y, z)) return LIGHT_MAX;
+    return get_channel(*light_cell(world, x, y, z), CHANNEL_SKY);
+}
+
+uint8_t light_get_block(const World* world, int x, int y, int z) {
+    if (!world || !world->chunks) return 0;
+    if (!world_in_bounds(world, x, y, z)) return 0;
+    return get_channel(*light_cell(world, x, y, z), CHANNEL_BLOCK);
+}
+
+static void propagate(World* world, LightQueue* q, int ch) {
+    LightNode n;
+    while (lq_pop(q, &n)) {
+        uint8_t level = get_channel(*light_cell(world, n.x, n.y, n.z), ch);
+        if (level <= 1) continue;
+
+        for (int d = 0; d < 6; d++) {
+            int x = n.x + k_dirs[d][0];
+            int y = n.y + k_dirs[d][1];
+            int z = n.z + k_dirs[d][2];
+            if (!world_in_bounds(world, x, y, z)) continue;
+            if (world_is_opaque(world_get(world, x, y, z))) continue;
+
+            uint8_t next = (ch == CHANNEL_SKY && d == DIR_DOWN && level == LIGHT_MAX) ? LIGHT_MAX : (uint8_t)(level - 1);
+            if (get_channel(*light_cell(world, x, y, z), ch) >= next) continue;
+            write_light(world, x, y, z, ch, next);
+            lq_push(q, x, y, z, next);
+        }
+    }
+}
+
+static void unpropagate(World* world, LightQueue* rem, LightQueue* add, int ch) {
+    LightNode n;
+    while (lq_pop(rem, &n)) {
+        for (int d = 0; d < 6; d++) {
+            int x = n.x + k_dirs[d][0];
+            int y = n.y + k_dirs[d][1];
+            int z = n.z + k_dirs[d][2];
+            if (!world_in_bounds(world, x, y, z)) continue;
+
+            uint8_t nl = get_channel(*light_cell(world, x, y, z), ch);
+            if (nl == 0) continue;
+
+            bool lit_by_us = nl < n.level ||
+                (ch == CHANNEL_SKY && d == DIR_DOWN && n.level == LIGHT_MAX && nl == LIGHT_MAX);
+            if (lit_by_us) {
+                write_light(world, x, y, z, ch, 0);
+                lq_push(rem, x, y, z, nl);
+            } else {
+                lq_push(add, x, y, z, nl);
+            }
+        }
+    }
+}
+
+void light_update_block(World* world, int x, int y, int z, BlockType old_t, BlockType new_t) {
+    (void)old_t;
+    (void)new_t;
+    BlockPos cell = { x, y, z };
+    light_update_blocks(world, &cell, 1);
+}
+
+void light_update_blocks(World* world, const BlockPos* cells, size_t count) {
+    if (!world || !world->chunks || count == 0) return;
+
+    LightQueue rem = { 0 };
+    LightQueue add = { 0 };
+
+    for (int ch = CHANNEL_BLOCK; ch <= CHANNEL_SKY; ch++) {
+        for (size_t i = 0; i < count; i++) {
+            const BlockPos* c = &cells[i];
+            if (!world_in_bounds(world, c->x, c->y, c->z)) continue;
+            uint8_t cur = get_channel(*light_cell(world, c->x, c->y, c->z), ch);
+            if (cur == 0) continue;
+            write_light(world, c->x, c->y, c->z, ch, 0);
+            lq_push(&rem, c->x, c->y, c->z, cur);
+        }
+        unpropagate(world, &rem, &add, ch);
+
+        for (size_t i = 0; i < count; i++) {
+            int x = cells[i].x;
+            int y = cells[i].y;
+            int z = cells[i].z;
+            if (!world_in_bounds(world, x, y, z)) continue;
+            BlockType t = world_get(world, x, y, z);
+
+            if (!world_is_opaque(t)) {
+                uint8_t seed = 0;
+                if (ch == CHANNEL_BLOCK) seed = world_light_emission(t);
+                if (ch == CHANNEL_SKY && y == world->h - 1) seed = LIGHT_MAX;
+                if (seed > get_channel(*light_cell(world, x, y, z), ch)) {
+                    write_light(world, x, y, z, ch, seed);
+                    lq_push(&add, x, y, z, seed);
+                }
+                for (int d = 0; d < 6; d++) {
+                    int nx = x + k_dirs[d][0];
+                    int ny = y + k_dirs[d][1];
+                    int nz = z + k_dirs[d][2];
+                    if (!world_in_bounds(world, nx, ny, nz)) continue;
+                    uint8_t nl = get_channel(*light_cell(world, nx, ny, nz), ch);
+                    if (nl > 1) lq_push(&add, nx, ny, nz, nl);
+                }
+            } else if (ch == CHANNEL_BLOCK && world_light_emission(t) > 0) {
+                uint8_t seed = world_light_emission(t);
+                write_light(world, x, y, z, ch, seed);
+                lq_push(&add, x, y, z, seed);
+            }
+        }
+
+        propagate(world, &add, ch);
+    }
+
+    lq_free(&rem);
+    lq_free(&add);
+}
+
+void light_compute_world(World* world) {
+    if (!world || !world->chunks) return;
+
+    size_t chunk_count = (size_t)world->chunks_x * (size_t)world->chunks_y * (size_t)world->chunks_z;
+    for (size_t i = 0; i < chunk_count; i++) {
+        int cx, cy, cz;
+        world_chunk_coords(world, (int)i, &cx, &cy, &cz);
+        Chunk* c = world_chunk_write(world, cx, cy, cz);
+        memset(c->light, 0, sizeof(c->light));
+        world_mark_chunk_dirty(world, (int)i);
+    }
+
+    int* tops = (int*)mem_alloc(MEM_TAG_SCRATCH, (size_t)world->w * (size_t)world->d * sizeof(int));
+    if (!tops) return;
+
+    for (int z = 0; z < world->d; z++) {
+        for (int x = 0; x < world->w; x++) {
+            int top = world_height(world, x, z, HEIGHTMAP_OPAQUE);
+            tops[z * world->w + x] = top;
+            for (int y = world->h - 1; y > top; y--) {
+                set_channel(light_cell_write(world, x, y, z), CHANNEL_SKY, LIGHT_MAX);
+            }
+        }
+    }
+
+    LightQueue q = { 0 };
+    for (int z = 0; z < world->d; z++) {
+        for (int x = 0; x < world->w; x++) {
+            int top = tops[z * world->w + x];
+            int reach = top;
+            if (x > 0 && tops[z * world->w + x - 1] > reach) reach = tops[z * world->w + x - 1];
+            if (x < world->w - 1 && tops[z * world->w + x + 1] > reach) reach = tops[z * world->w + x + 1];
+            if (z > 0 && tops[(z - 1) * world->w + x] > reach) reach = tops[(z - 1) * world->w + x];
+            if (z < world->d - 1 && tops[(z + 1) * world->w + x] > reach) reach = tops[(z + 1) * world->w + x];
+            for (int y = top + 1; y <= reach; y++) {
+                lq_push(&q, x, y, z, LIGHT_MAX);
+            }
+        }
+    }
+    mem_free(MEM_TAG_SCRATCH, tops);
+    propagate(world, &q, CHANNEL_SKY);
+
+    for (int y = 0; y < world->h; y++) {
+        for (int z = 0; z < world->d; z++) {
+            for (int x = 0; x < world->w; x++) {
+                uint8_t emit = world_light_emission(world_get(world, x, y, z));
+                if (emit == 0) continue;
+                set_channel(light_cell_write(world, x, y, z), CHANNEL_BLOCK, emit);
+                lq_push(&q, x, y, z, emit);
+            }
+        }
+    }
+    propagate(world, &q, CHANNEL_BLOCK);
+    lq_free(&q);
+
+    world->light_ready = true;
+}
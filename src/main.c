@@ -1,13 +1,27 @@
 #include "app.h"
+#include "block.h"
+#include "block_tick.h"
 #include "camera.h"
+#include "chunk_cache.h"
+#include "chunk_slab.h"
 #include "gl_loader.h"
+#include "governor.h"
 #include "math4.h"
+#include "mem_track.h"
 #include "renderer.h"
+#include "replay.h"
+#include "sim.h"
+#include "thread.h"
+#include "upload_queue.h"
+#include "snapshot.h"
 #include "world.h"
+#include "world_save.h"
 
+#include <limits.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -20,7 +34,7 @@ typedef struct DynFloats {
 static void df_push(DynFloats* a, float v) {
     if (a->count + 1 > a->cap) {
         size_t new_cap = a->cap ? a->cap * 2 : 1024;
-        float* p = (float*)realloc(a->data, new_cap * sizeof(float));
+        float* p = (float*)mem_realloc(MEM_TAG_MESH, a->data, new_cap * sizeof(float));
         if (!p) return;
         a->data = p;
         a->cap = new_cap;
@@ -28,7 +42,7 @@ static void df_push(DynFloats* a, float v) {
     a->data[a->count++] = v;
 }
 
-static void push_vertex(DynFloats* a, float px, float py, float pz, float u, float v, float nx, float ny, float nz) {
+static void push_vertex(DynFloats* a, float px, float py, float pz, float u, float v, float nx, float ny, float nz, float sky, float blk) {
     df_push(a, px);
     df_push(a, py);
     df_push(a, pz);
@@ -37,82 +51,71 @@ static void push_vertex(DynFloats* a, float px, float py, float pz, float u, flo
     df_push(a, nx);
     df_push(a, ny);
     df_push(a, nz);
+    df_push(a, sky);
+    df_push(a, blk);
 }
 
-static void tile_uv(int tile_x, float local_u, float local_v, float* out_u, float* out_v) {
-    const float atlas_w = 64.0f;
-    const float atlas_h = 16.0f;
-    const float tile = 16.0f;
-    const float pad = 0.5f;
-
-    float u0 = (tile_x * tile + pad) / atlas_w;
-    float v0 = (0.0f + pad) / atlas_h;
-    float u1 = ((tile_x + 1) * tile - pad) / atlas_w;
-    float v1 = ((0.0f + 1.0f) * tile - pad) / atlas_h;
-
-    *out_u = u0 + (u1 - u0) * local_u;
-    *out_v = v0 + (v1 - v0) * local_v;
-}
-
-static void add_face(DynFloats* a, float x, float y, float z, int face, int tile_x, float sx, float sy, float sz) {
-    float u00, v00, u10, v10, u11, v11, u01, v01;
-    tile_uv(tile_x, 0.0f, 0.0f, &u00, &v00);
-    tile_uv(tile_x, 1.0f, 0.0f, &u10, &v10);
-    tile_uv(tile_x, 1.0f, 1.0f, &u11, &v11);
-    tile_uv(tile_x, 0.0f, 1.0f, &u01, &v01);
+static void add_face(DynFloats* a, float x, float y, float z, int face, int tile, float sx, float sy, float sz) {
+    const float sky = 1.0f;
+    const float blk = 0.0f;
+    const float* uv = g_tile_uv[tile];
+    float u00 = uv[0], v00 = uv[1];
+    float u10 = uv[2], v10 = uv[1];
+    float u11 = uv[2], v11 = uv[3];
+    float u01 = uv[0], v01 = uv[3];
 
     if (face == 0) {
-        push_vertex(a, x + sx, y + 0,  z + 0,  u00, v00, 1, 0, 0);
-        push_vertex(a, x + sx, y + sy, z + 0,  u01, v01, 1, 0, 0);
-        push_vertex(a, x + sx, y + sy, z + sz, u11, v11, 1, 0, 0);
-        push_vertex(a, x + sx, y + 0,  z + 0,  u00, v00, 1, 0, 0);
-        push_vertex(a, x + sx, y + sy, z + sz, u11, v11, 1, 0, 0);
-        push_vertex(a, x + sx, y + 0,  z + sz, u10, v10, 1, 0, 0);
+        push_vertex(a, x + sx, y + 0,  z + 0,  u00, v00, 1, 0, 0, sky, blk);
+        push_vertex(a, x + sx, y + sy, z + 0,  u01, v01, 1, 0, 0, sky, blk);
+        push_vertex(a, x + sx, y + sy, z + sz, u11, v11, 1, 0, 0, sky, blk);
+        push_vertex(a, x + sx, y + 0,  z + 0,  u00, v00, 1, 0, 0, sky, blk);
+        push_vertex(a, x + sx, y + sy, z + sz, u11, v11, 1, 0, 0, sky, blk);
+        push_vertex(a, x + sx, y + 0,  z + sz, u10, v10, 1, 0, 0, sky, blk);
         return;
     }
     if (face == 1) {
-        push_vertex(a, x + 0,  y + 0,  z + sz, u00, v00, -1, 0, 0);
-        push_vertex(a, x + 0,  y + sy, z + sz, u01, v01, -1, 0, 0);
-        push_vertex(a, x + 0,  y + sy, z + 0,  u11, v11, -1, 0, 0);
-        push_vertex(a, x + 0,  y + 0,  z + sz, u00, v00, -1, 0, 0);
-        push_vertex(a, x + 0,  y + sy, z + 0,  u11, v11, -1, 0, 0);
-        push_vertex(a, x + 0,  y + 0,  z + 0,  u10, v10, -1, 0, 0);
+        push_vertex(a, x + 0,  y + 0,  z + sz, u00, v00, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0,  y + sy, z + sz, u01, v01, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0,  y + sy, z + 0,  u11, v11, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0,  y + 0,  z + sz, u00, v00, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0,  y + sy, z + 0,  u11, v11, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0,  y + 0,  z + 0,  u10, v10, -1, 0, 0, sky, blk);
         return;
     }
     if (face == 2) {
-        push_vertex(a, x + 0,  y + sy, z + 0,  u00, v00, 0, 1, 0);
-        push_vertex(a, x + 0,  y + sy, z + sz, u01, v01, 0, 1, 0);
-        push_vertex(a, x + sx, y + sy, z + sz, u11, v11, 0, 1, 0);
-        push_vertex(a, x + 0,  y + sy, z + 0,  u00, v00, 0, 1, 0);
-        push_vertex(a, x + sx, y + sy, z + sz, u11, v11, 0, 1, 0);
-        push_vertex(a, x + sx, y + sy, z + 0,  u10, v10, 0, 1, 0);
+        push_vertex(a, x + 0,  y + sy, z + 0,  u00, v00, 0, 1, 0, sky, blk);
+        push_vertex(a, x + 0,  y + sy, z + sz, u01, v01, 0, 1, 0, sky, blk);
+        push_vertex(a, x + sx, y + sy, z + sz, u11, v11, 0, 1, 0, sky, blk);
+        push_vertex(a, x + 0,  y + sy, z + 0,  u00, v00, 0, 1, 0, sky, blk);
+        push_vertex(a, x + sx, y + sy, z + sz, u11, v11, 0, 1, 0, sky, blk);
+        push_vertex(a, x + sx, y + sy, z + 0,  u10, v10, 0, 1, 0, sky, blk);
         return;
     }
     if (face == 3) {
-        push_vertex(a, x + sx, y + 0,  z + 0,  u00, v00, 0, -1, 0);
-        push_vertex(a, x + sx, y + 0,  z + sz, u01, v01, 0, -1, 0);
-        push_vertex(a, x + 0,  y + 0,  z + sz, u11, v11, 0, -1, 0);
-        push_vertex(a, x + sx, y + 0,  z + 0,  u00, v00, 0, -1, 0);
-        push_vertex(a, x + 0,  y + 0,  z + sz, u11, v11, 0, -1, 0);
-        push_vertex(a, x + 0,  y + 0,  z + 0,  u10, v10, 0, -1, 0);
+        push_vertex(a, x + sx, y + 0,  z + 0,  u00, v00, 0, -1, 0, sky, blk);
+        push_vertex(a, x + sx, y + 0,  z + sz, u01, v01, 0, -1, 0, sky, blk);
+        push_vertex(a, x + 0,  y + 0,  z + sz, u11, v11, 0, -1, 0, sky, blk);
+        push_vertex(a, x + sx, y + 0,  z + 0,  u00, v00, 0, -1, 0, sky, blk);
+        push_vertex(a, x + 0,  y + 0,  z + sz, u11, v11, 0, -1, 0, sky, blk);
+        push_vertex(a, x + 0,  y + 0,  z + 0,  u10, v10, 0, -1, 0, sky, blk);
         return;
     }
     if (face == 4) {
-        push_vertex(a, x + 0,  y + 0,  z + 0,  u00, v00, 0, 0, -1);
-        push_vertex(a, x + 0,  y + sy, z + 0,  u01, v01, 0, 0, -1);
-        push_vertex(a, x + sx, y + sy, z + 0,  u11, v11, 0, 0, -1);
-        push_vertex(a, x + 0,  y + 0,  z + 0,  u00, v00, 0, 0, -1);
-        push_vertex(a, x + sx, y + sy, z + 0,  u11, v11, 0, 0, -1);
-        push_vertex(a, x + sx, y + 0,  z + 0,  u10, v10, 0, 0, -1);
+        push_vertex(a, x + 0,  y + 0,  z + 0,  u00, v00, 0, 0, -1, sky, blk);
+        push_vertex(a, x + 0,  y + sy, z + 0,  u01, v01, 0, 0, -1, sky, blk);
+        push_vertex(a, x + sx, y + sy, z + 0,  u11, v11, 0, 0, -1, sky, blk);
+        push_vertex(a, x + 0,  y + 0,  z + 0,  u00, v00, 0, 0, -1, sky, blk);
+        push_vertex(a, x + sx, y + sy, z + 0,  u11, v11, 0, 0, -1, sky, blk);
+        push_vertex(a, x + sx, y + 0,  z + 0,  u10, v10, 0, 0, -1, sky, blk);
         return;
     }
     if (face == 5) {
-        push_vertex(a, x + sx, y + 0,  z + sz, u00, v00, 0, 0, 1);
-        push_vertex(a, x + sx, y + sy, z + sz, u01, v01, 0, 0, 1);
-        push_vertex(a, x + 0,  y + sy, z + sz, u11, v11, 0, 0, 1);
-        push_vertex(a, x + sx, y + 0,  z + sz, u00, v00, 0, 0, 1);
-        push_vertex(a, x + 0,  y + sy, z + sz, u11, v11, 0, 0, 1);
-        push_vertex(a, x + 0,  y + 0,  z + sz, u10, v10, 0, 0, 1);
+        push_vertex(a, x + sx, y + 0,  z + sz, u00, v00, 0, 0, 1, sky, blk);
+        push_vertex(a, x + sx, y + sy, z + sz, u01, v01, 0, 0, 1, sky, blk);
+        push_vertex(a, x + 0,  y + sy, z + sz, u11, v11, 0, 0, 1, sky, blk);
+        push_vertex(a, x + sx, y + 0,  z + sz, u00, v00, 0, 0, 1, sky, blk);
+        push_vertex(a, x + 0,  y + sy, z + sz, u11, v11, 0, 0, 1, sky, blk);
+        push_vertex(a, x + 0,  y + 0,  z + sz, u10, v10, 0, 0, 1, sky, blk);
         return;
     }
 }
@@ -120,7 +123,7 @@ static void add_face(DynFloats* a, float x, float y, float z, int face, int tile
 static Mesh make_hand_mesh(void) {
     DynFloats verts = { 0 };
     float sx = 0.20f, sy = 0.20f, sz = 0.20f;
-    int tile = 2;
+    int tile = g_block_face_tile[BLOCK_DIRT][0];
     add_face(&verts, -sx * 0.5f, -sy * 0.5f, -sz * 0.5f, 0, tile, sx, sy, sz);
     add_face(&verts, -sx * 0.5f, -sy * 0.5f, -sz * 0.5f, 1, tile, sx, sy, sz);
     add_face(&verts, -sx * 0.5f, -sy * 0.5f, -sz * 0.5f, 2, tile, sx, sy, sz);
@@ -129,7 +132,7 @@ static Mesh make_hand_mesh(void) {
     add_face(&verts, -sx * 0.5f, -sy * 0.5f, -sz * 0.5f, 5, tile, sx, sy, sz);
     Mesh m = { 0 };
     m.vertices = verts.data;
-    m.vertex_count = verts.count / 8;
+    m.vertex_count = verts.count / MESH_VERTEX_FLOATS;
     return m;
 }
 
@@ -150,137 +153,254 @@ static Mat4 make_model(Vec3 pos, Vec3 right, Vec3 up, Vec3 forward) {
     return m;
 }
 
-static bool aabb_hits_world(const World* world, float minx, float miny, float minz, float maxx, float maxy, float maxz) {
-    int x0 = (int)floorf(minx);
-    int y0 = (int)floorf(miny);
-    int z0 = (int)floorf(minz);
-    int x1 = (int)floorf(maxx);
-    int y1 = (int)floorf(maxy);
-    int z1 = (int)floorf(maxz);
-
-    for (int z = z0; z <= z1; z++) {
-        for (int y = y0; y <= y1; y++) {
-            for (int x = x0; x <= x1; x++) {
-                BlockType t = world_get(world, x, y, z);
-                if (world_is_solid(t)) return true;
-            }
-        }
-    }
-    return false;
-}
-
-static void move_player(World* world, Camera* cam, const AppInput* in, float dt) {
-    const float player_radius = 0.3f;
-    const float player_height = 1.8f;
-    const float eye_height = 1.62f;
+static Mat4 hand_model(const Camera* cam) {
+    Vec3 eye = camera_eye(cam);
 
-    const float mouse_sensitivity = 0.0022f;
-    camera_apply_mouse(cam, in->mouse_dx, in->mouse_dy, mouse_sensitivity);
+    float cy = cosf(cam->yaw);
+    float sy = sinf(cam->yaw);
+    float cp = cosf(cam->pitch);
+    float sp = sinf(cam->pitch);
 
-    float speed = in->keys[VK_SHIFT] ? 8.0f : 5.0f;
-    Vec3 f = camera_forward_xz(cam);
-    Vec3 r = camera_right_xz(cam);
-    Vec3 move = (Vec3){ 0 };
+    Vec3 forward = vec3_norm((Vec3){ sy * cp, sp, -cy * cp });
+    Vec3 right = camera_right_xz(cam);
+    Vec3 up = vec3_cross(right, forward);
 
-    if (in->keys['W']) move = vec3_add(move, f);
-    if (in->keys['S']) move = vec3_sub(move, f);
-    if (in->keys['D']) move = vec3_add(move, r);
-    if (in->keys['A']) move = vec3_sub(move, r);
+    Vec3 pos = eye;
+    vec3_madd_p(&pos, &forward, 0.6f);
+    vec3_madd_p(&pos, &right, 0.35f);
+    vec3_madd_p(&pos, &up, -0.3f);
+    return make_model(pos, right, up, forward);
+}
 
-    if (vec3_len(move) > 0.001f) move = vec3_norm(move);
+static bool load_or_generate_world(Snapshot* snap, bool use_snapshot, const char* load_path, WorldGenerator generator, uint64_t seed, World* world, Mesh** out_meshes, bool* out_hit) {
+    const int w = 64, h = 24, d = 64;
+    uint64_t key = snapshot_key(w, h, d, seed, (uint32_t)generator);
 
-    cam->velocity.x = move.x * speed;
-    cam->velocity.z = move.z * speed;
+    *out_hit = false;
+    if (load_path) {
+        if (!world_save_read(world, load_path, out_meshes)) {
+            fprintf(stderr, "world: cannot load %s\n", load_path);
+            return false;
+        }
+        if (!*out_meshes) *out_meshes = world_build_chunk_meshes(world);
+        if (!*out_meshes) {
+            world_shutdown(world);
+            return false;
+        }
+        world_clear_dirty(world);
+        return true;
+    }
+    if (use_snapshot && snapshot_load(snap, SNAPSHOT_PATH, key, world, out_meshes)) {
+        *out_hit = true;
+        return true;
+    }
 
-    if (cam->on_ground && in->keys[VK_SPACE]) {
-        cam->velocity.y = 7.0f;
-        cam->on_ground = false;
+    if (!world_init(world, w, h, d)) return false;
+    world_generate(world, generator, seed);
+    *out_meshes = world_build_chunk_meshes(world);
+    if (!*out_meshes) {
+        world_shutdown(world);
+        return false;
     }
+    world_clear_dirty(world);
+    snapshot_save(SNAPSHOT_PATH, key, world, *out_meshes);
+    return true;
+}
 
-    cam->velocity.y += -20.0f * dt;
-    if (cam->velocity.y < -60.0f) cam->velocity.y = -60.0f;
+static Vec3 chunk_origin(const World* world, int index) {
+    int cx, cy, cz;
+    world_chunk_coords(world, index, &cx, &cy, &cz);
+    return (Vec3){ (float)(cx << CHUNK_SHIFT), (float)(cy << CHUNK_SHIFT), (float)(cz << CHUNK_SHIFT) };
+}
 
-    Vec3 p = cam->position_feet;
+static bool upload_chunk_meshes(Renderer* r, const World* world, const Mesh* meshes) {
+    int n = world_chunk_count(world);
+    if (!renderer_chunks_init(r, n)) return false;
+    for (int i = 0; i < n; i++) {
+        if (!renderer_chunk_upload(r, i, &meshes[i], chunk_origin(world, i))) return false;
+    }
+    return true;
+}
 
-    p.x += cam->velocity.x * dt;
-    {
-        float minx = p.x - player_radius;
-        float maxx = p.x + player_radius;
-        float miny = p.y;
-        float maxy = p.y + player_height;
-        float minz = p.z - player_radius;
-        float maxz = p.z + player_radius;
-        if (aabb_hits_world(world, minx, miny, minz, maxx, maxy, maxz)) {
-            p.x -= cam->velocity.x * dt;
-            cam->velocity.x = 0.0f;
+static void remesh_dirty_chunks(UploadQueue* q, World* world, int budget) {
+    int dirty[64];
+    int n;
+    while (budget > 0 && (n = world_take_dirty_chunks(world, dirty, budget < 64 ? budget : 64)) > 0) {
+        budget -= n;
+        for (int i = 0; i < n; i++) {
+            int cx, cy, cz;
+            world_chunk_coords(world, dirty[i], &cx, &cy, &cz);
+            if (world->cache) chunk_cache_touch(world->cache, dirty[i]);
+            Mesh mesh = world_build_chunk_mesh(world, cx, cy, cz);
+            upload_queue_submit(q, dirty[i], mesh, chunk_origin(world, dirty[i]));
         }
     }
+}
 
-    p.z += cam->velocity.z * dt;
-    {
-        float minx = p.x - player_radius;
-        float maxx = p.x + player_radius;
-        float miny = p.y;
-        float maxy = p.y + player_height;
-        float minz = p.z - player_radius;
-        float maxz = p.z + player_radius;
-        if (aabb_hits_world(world, minx, miny, minz, maxx, maxy, maxz)) {
-            p.z -= cam->velocity.z * dt;
-            cam->velocity.z = 0.0f;
+static void trim_chunk_cache(ChunkCache* cache, UploadQueue* q, Renderer* r, World* world, Vec3 eye, Mat4 vp, float view_distance) {
+    chunk_cache_begin_frame(cache, eye, vp, view_distance);
+    int count = world_chunk_count(world);
+    for (int i = 0; i < count; i++) chunk_cache_set_mesh_bytes(cache, i, renderer_chunk_bytes(r, i));
+    int ids[64];
+    int n;
+    while ((n = chunk_cache_trim_meshes(cache, ids, 64)) > 0) {
+        for (int i = 0; i < n; i++) {
+            upload_queue_cancel(q, ids[i]);
+            renderer_chunk_clear(r, ids[i]);
         }
     }
+    while ((n = chunk_cache_take_mesh_reloads(cache, ids, 64)) > 0) {
+        for (int i = 0; i < n; i++) world_chunk_at(world, ids[i])->dirty = true;
+    }
+    chunk_cache_trim_blocks(cache);
+}
 
-    float dy = cam->velocity.y * dt;
-    p.y += dy;
-    cam->on_ground = false;
-    {
-        float minx = p.x - player_radius;
-        float maxx = p.x + player_radius;
-        float miny = p.y;
-        float maxy = p.y + player_height;
-        float minz = p.z - player_radius;
-        float maxz = p.z + player_radius;
-
-        if (aabb_hits_world(world, minx, miny, minz, maxx, maxy, maxz)) {
-            p.y -= dy;
-            if (dy < 0.0f) cam->on_ground = true;
-            cam->velocity.y = 0.0f;
-        }
+typedef struct FrameTimes {
+    float* ms;
+    size_t count;
+    size_t cap;
+} FrameTimes;
+
+static void frame_times_push(FrameTimes* f, float ms) {
+    if (f->count + 1 > f->cap) {
+        size_t new_cap = f->cap ? f->cap * 2 : 4096;
+        float* p = (float*)mem_realloc(MEM_TAG_SCRATCH, f->ms, new_cap * sizeof(float));
+        if (!p) return;
+        f->ms = p;
+        f->cap = new_cap;
     }
+    f->ms[f->count++] = ms;
+}
 
-    if (p.y < 1.0f) {
-        p.y = 1.0f;
-        cam->velocity.y = 0.0f;
-        cam->on_ground = true;
+static int compare_floats(const void* a, const void* b) {
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+static float frame_times_percentile(FrameTimes* f, double pct) {
+    if (f->count == 0) return 0.0f;
+    qsort(f->ms, f->count, sizeof(float), compare_floats);
+    size_t i = (size_t)(pct / 100.0 * (double)(f->count - 1) + 0.5);
+    return f->ms[i];
+}
+
+#define RENDER_STATS_INTERVAL 5.0
+
+static void log_render_stats(const RenderStats* s) {
+    fprintf(stderr, "render: %u draws, %llu tris, %llu KiB uploaded, %u chunks, gl %u issued/%u skipped, gpu",
+        s->draw_calls, (unsigned long long)s->triangles, (unsigned long long)(s->upload_bytes / 1024),
+        s->chunks_drawn, s->state_calls, s->state_skipped);
+    for (int pass = 0; pass < RENDER_PASS_COUNT; pass++) {
+        fprintf(stderr, " %s %.2f ms", renderer_pass_name((RenderPass)pass), s->gpu_ms[pass]);
     }
+    fprintf(stderr, "\n");
+}
 
-    cam->position_feet = p;
+static void log_upload_stats(const UploadQueueStats* s) {
+    fprintf(stderr, "uploads: %llu chunks, %llu KiB, %llu superseded, %llu frames over budget, %d pending\n",
+        (unsigned long long)s->uploaded, (unsigned long long)(s->uploaded_bytes / 1024), (unsigned long long)s->superseded,
+        (unsigned long long)s->deferred_frames, s->pending);
+}
 
-    (void)eye_height;
+static void log_cache_stats(const ChunkCacheStats* s) {
+    fprintf(stderr, "chunk cache: %d chunks %zu KiB, %d meshes %zu KiB, %llu hits/%llu misses, %llu evicted (%llu written, %llu uniform), %llu meshes dropped/%llu reloaded\n",
+        s->resident_chunks, s->block_bytes / 1024, s->resident_meshes, s->mesh_bytes / 1024,
+        (unsigned long long)s->hits, (unsigned long long)s->misses, (unsigned long long)s->evictions,
+        (unsigned long long)s->writebacks, (unsigned long long)s->uniform_evictions,
+        (unsigned long long)s->mesh_evictions, (unsigned long long)s->mesh_reloads);
 }
 
-static Mat4 camera_view_proj(const Camera* cam, int width, int height) {
-    const float eye_height = 1.62f;
-    Vec3 eye = (Vec3){ cam->position_feet.x, cam->position_feet.y + eye_height, cam->position_feet.z };
+static void log_slab_stats(const ChunkSlabStats* s) {
+    fprintf(stderr, "chunk slabs: %d slabs %zu KiB, %d live chunks, %llu allocs/%llu frees, %llu refills/%llu flushes\n",
+        s->slabs, s->slab_bytes / 1024, s->live, (unsigned long long)s->allocs, (unsigned long long)s->frees,
+        (unsigned long long)s->refills, (unsigned long long)s->flushes);
+}
 
-    float cy = cosf(cam->yaw);
-    float sy = sinf(cam->yaw);
-    float cp = cosf(cam->pitch);
-    float sp = sinf(cam->pitch);
+static void log_save_stats(const WorldSaveStats* s, double snapshot_ms, double total_ms) {
+    fprintf(stderr, "autosave: %d chunks, %llu KiB -> %llu KiB, snapshot %.2f ms, written in %.1f ms\n",
+        s->chunks, (unsigned long long)(s->raw_bytes / 1024), (unsigned long long)(s->file_bytes / 1024), snapshot_ms, total_ms);
+}
 
-    Vec3 forward = (Vec3){ sy * cp, sp, -cy * cp };
-    forward = vec3_norm(forward);
+static void log_tick_stats(const BlockTickStats* s) {
+    fprintf(stderr, "block ticks: %llu ticks, %llu scheduled, %llu random, %llu changed, %llu deferred, %d active/%d queued chunks, %d pending\n",
+        (unsigned long long)s->ticks, (unsigned long long)s->scheduled_run, (unsigned long long)s->random_run,
+        (unsigned long long)s->changed, (unsigned long long)s->deferred, s->active_chunks, s->queued_chunks, s->pending);
+}
 
-    Mat4 view = mat4_look(eye, forward, (Vec3){ 0.0f, 1.0f, 0.0f });
-    float aspect = (height > 0) ? ((float)width / (float)height) : 1.0f;
-    Mat4 proj = mat4_perspective(70.0f * (3.14159265f / 180.0f), aspect, 0.05f, 300.0f);
-    return mat4_mul(proj, view);
+static void log_governor_stats(const GovernorStats* s) {
+    fprintf(stderr, "governor: level %d, avg %.2f ms (worst %.2f), view %.0f, remesh %d/frame, %u down/%u up\n",
+        s->level, s->avg_ms, s->worst_ms, s->view_distance, s->remesh_budget, s->downgrades, s->upgrades);
 }
 
-int main(void) {
+int main(int argc, char** argv) {
+    double startup_t0 = app_time_seconds();
+    block_registry_init();
+
+    bool sim_threaded = false;
+    bool use_snapshot = true;
+    bool render_stats = false;
+    bool mem_stats = false;
+    bool use_governor = true;
+    bool use_flat = false;
+    bool block_ticks = true;
+    double target_ms = GOVERNOR_DEFAULT_TARGET_MS;
+    size_t upload_budget = UPLOAD_QUEUE_DEFAULT_BYTES;
+    size_t chunk_budget = 0;
+    double autosave_interval = 0.0;
+    const char* load_path = NULL;
+    size_t mesh_budget = 0;
+    const char* record_path = NULL;
+    const char* replay_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sim-thread") == 0) sim_threaded = true;
+        if (strcmp(argv[i], "--no-snapshot") == 0) use_snapshot = false;
+        if (strcmp(argv[i], "--render-stats") == 0) render_stats = true;
+        if (strcmp(argv[i], "--mem-stats") == 0) mem_stats = true;
+        if (strcmp(argv[i], "--no-governor") == 0) use_governor = false;
+        if (strcmp(argv[i], "--flat") == 0) use_flat = true;
+        if (strcmp(argv[i], "--no-block-ticks") == 0) block_ticks = false;
+        if (strcmp(argv[i], "--target-ms") == 0 && i + 1 < argc) target_ms = atof(argv[++i]);
+        if (strcmp(argv[i], "--upload-budget-kb") == 0 && i + 1 < argc) upload_budget = (size_t)atoi(argv[++i]) * 1024u;
+        if (strcmp(argv[i], "--chunk-budget-mb") == 0 && i + 1 < argc) chunk_budget = (size_t)atoi(argv[++i]) * 1024u * 1024u;
+        if (strcmp(argv[i], "--mesh-budget-mb") == 0 && i + 1 < argc) mesh_budget = (size_t)atoi(argv[++i]) * 1024u * 1024u;
+        if (strcmp(argv[i], "--autosave") == 0 && i + 1 < argc) autosave_interval = atof(argv[++i]);
+        if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) load_path = argv[++i];
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) record_path = argv[++i];
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replay_path = argv[++i];
+    }
+
+    uint64_t world_seed = 0;
+    WorldGenerator generator = use_flat ? WORLD_GEN_FLAT : WORLD_GEN_TERRAIN;
+    int tick_hz = SIM_DEFAULT_TICK_HZ;
+    ReplayReader replay = { 0 };
+    if (load_path && (record_path || replay_path)) {
+        fprintf(stderr, "replay: --load cannot be combined with --record or --replay, replays regenerate the world from its seed\n");
+        return 1;
+    }
+    if (replay_path) {
+        if (!replay_reader_open(&replay, replay_path)) {
+            fprintf(stderr, "replay: cannot read %s\n", replay_path);
+            return 1;
+        }
+        world_seed = replay.seed;
+        generator = (WorldGenerator)replay.generator;
+        tick_hz = replay.tick_hz;
+        record_path = NULL;
+    }
+    if ((record_path || replay_path) && sim_threaded) {
+        fprintf(stderr, "replay: --sim-thread ignored, recording and replay need the stepped sim\n");
+        sim_threaded = false;
+    }
+    if (chunk_budget > 0 && sim_threaded) {
+        fprintf(stderr, "chunk cache: --sim-thread ignored, evicting chunks needs the stepped sim\n");
+        sim_threaded = false;
+    }
+
     AppWindow* win = NULL;
     AppWindowDesc desc = { "Minecraft C (Voxel)", 1280, 720 };
     if (!app_window_create(&win, desc)) {
+        replay_reader_close(&replay);
         return 1;
     }
     app_window_set_cursor_locked(win, true);
@@ -296,56 +416,239 @@ int main(void) {
     }
 
     Renderer renderer;
+    double renderer_t0 = app_time_seconds();
     if (!renderer_init(&renderer)) {
         app_window_destroy(win);
         return 1;
     }
+    fprintf(stderr, "renderer: init %.1f ms, %d/%d programs from shader cache\n",
+        (app_time_seconds() - renderer_t0) * 1000.0, renderer.shader_stats.cache_hits, renderer.shader_stats.programs_built);
 
     World world;
-    if (!world_init(&world, 64, 24, 64)) {
+    Mesh* chunk_meshes = NULL;
+    Snapshot snap = { 0 };
+    bool snapshot_hit = false;
+    double world_t0 = app_time_seconds();
+    if (!load_or_generate_world(&snap, use_snapshot, load_path, generator, world_seed, &world, &chunk_meshes, &snapshot_hit)) {
+        renderer_shutdown(&renderer);
+        app_window_destroy(win);
+        return 1;
+    }
+    fprintf(stderr, "world: ready in %.1f ms (snapshot %s)\n",
+        (app_time_seconds() - world_t0) * 1000.0, snapshot_hit ? "hit" : "miss");
+
+    BlockTicker ticks = { 0 };
+    BlockTickDesc tick_desc = { world_seed, BLOCK_TICK_RANDOM_PER_CHUNK, BLOCK_TICK_DEFAULT_BUDGET, thread_hardware_concurrency() };
+    if (block_ticks && !block_tick_init(&ticks, &world, tick_desc)) {
+        fprintf(stderr, "block ticks: out of memory, world stays static\n");
+    }
+
+    ChunkCache cache;
+    if ((chunk_budget > 0 || mesh_budget > 0) && !chunk_cache_init(&cache, &world, CHUNK_CACHE_PATH, chunk_budget, mesh_budget)) {
+        fprintf(stderr, "chunk cache: cannot open %s, running without budgets\n", CHUNK_CACHE_PATH);
+    }
+
+    bool chunks_ok = upload_chunk_meshes(&renderer, &world, chunk_meshes);
+    world_free_chunk_meshes(chunk_meshes, world_chunk_count(&world));
+    if (!chunks_ok) {
+        if (world.cache) chunk_cache_shutdown(&cache);
+        block_tick_shutdown(&ticks);
+        world_shutdown(&world);
+        snapshot_close(&snap);
         renderer_shutdown(&renderer);
         app_window_destroy(win);
         return 1;
     }
-    world_generate_flat(&world);
-    Mesh mesh = world_build_mesh(&world);
+
+    Mesh hand_mesh = make_hand_mesh();
+    GpuMesh hand_gpu;
+    if (!renderer_upload_mesh(&renderer, &hand_mesh, &hand_gpu)) {
+        mesh_free(&hand_mesh);
+        if (world.cache) chunk_cache_shutdown(&cache);
+        block_tick_shutdown(&ticks);
+        world_shutdown(&world);
+        snapshot_close(&snap);
+        renderer_shutdown(&renderer);
+        app_window_destroy(win);
+        return 1;
+    }
+    mesh_free(&hand_mesh);
 
     Camera cam;
     camera_init(&cam);
-    cam.position_feet = (Vec3){ 12.0f, 8.0f, 12.0f };
+    cam.position_feet = world_spawn_point(&world);
+
+    Sim sim;
+    SimDesc sim_desc = { &world, cam, tick_hz, sim_threaded, app_time_seconds, ticks.world ? &ticks : NULL };
+    if (!sim_init(&sim, sim_desc)) {
+        renderer_free_mesh(&hand_gpu);
+        if (world.cache) chunk_cache_shutdown(&cache);
+        block_tick_shutdown(&ticks);
+        world_shutdown(&world);
+        snapshot_close(&snap);
+        renderer_shutdown(&renderer);
+        app_window_destroy(win);
+        return 1;
+    }
+
+    ReplayWriter recorder = { 0 };
+    if (record_path && !replay_writer_open(&recorder, record_path, world_seed, (uint32_t)generator, tick_hz)) {
+        fprintf(stderr, "replay: cannot write %s\n", record_path);
+    }
+
+    UploadQueue uploads;
+    if (!upload_queue_init(&uploads, world_chunk_count(&world), upload_budget ? upload_budget : SIZE_MAX,
+            upload_budget ? UPLOAD_QUEUE_DEFAULT_MS : 1.0e9, app_time_seconds)) {
+        sim_shutdown(&sim);
+        renderer_free_mesh(&hand_gpu);
+        if (world.cache) chunk_cache_shutdown(&cache);
+        block_tick_shutdown(&ticks);
+        world_shutdown(&world);
+        snapshot_close(&snap);
+        renderer_shutdown(&renderer);
+        app_window_destroy(win);
+        return 1;
+    }
+
+    Governor governor;
+    GovernorDesc governor_desc = { target_ms, 48.0f, 160.0f, 4, 64 };
+    governor_init(&governor, governor_desc);
 
     AppInput input;
     memset(&input, 0, sizeof(input));
 
+    WorldSaveJob autosave = { 0 };
+    double autosave_t0 = app_time_seconds();
+    double autosave_snapshot_ms = 0.0;
+
+    bool first_frame = true;
     double prev = app_time_seconds();
+    double stats_t0 = prev;
+    uint32_t frames = 0;
+    FrameTimes frame_times = { 0 };
     while (!input.quit_requested) {
         app_window_poll(win, &input);
-        if (input.keys[VK_ESCAPE]) break;
+        if (input.keys[APP_KEY_ESCAPE]) break;
         if (!input.has_focus) {
             input.mouse_dx = 0;
             input.mouse_dy = 0;
         }
 
         double now = app_time_seconds();
-        float dt = (float)(now - prev);
+        double frame_dt = now - prev;
         prev = now;
-        if (dt > 0.05f) dt = 0.05f;
+        if (frames > 0) {
+            frame_times_push(&frame_times, (float)(frame_dt * 1000.0));
+            if (use_governor && governor_frame(&governor, frame_dt * 1000.0) && render_stats) {
+                log_governor_stats(governor_stats(&governor));
+            }
+        }
+
+        remesh_dirty_chunks(&uploads, &world, use_governor ? governor_remesh_budget(&governor) : INT_MAX);
+
+        if (replay.data) {
+            AppInput live = input;
+            if (!replay_reader_next(&replay, &input, &frame_dt)) break;
+            input.width = live.width;
+            input.height = live.height;
+        }
+        if (recorder.file) replay_writer_frame(&recorder, &input, frame_dt);
+        frames++;
 
-        move_player(&world, &cam, &input, dt);
+        sim_submit_input(&sim, &input);
+        sim_update(&sim, frame_dt);
+        Camera view_cam = sim_camera(&sim, NULL);
 
         renderer_resize(input.width, input.height);
 
         glClearColor(0.52f, 0.75f, 0.95f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        Mat4 vp = camera_view_proj(&cam, input.width, input.height);
-        renderer_draw_mesh(&renderer, &mesh, vp);
+        Mat4 vp = camera_view_proj(&view_cam, input.width, input.height);
+        Vec3 eye = camera_eye(&view_cam);
+        float view_distance = use_governor ? governor_view_distance(&governor) : 0.0f;
+        if (world.cache) trim_chunk_cache(&cache, &uploads, &renderer, &world, eye, vp, view_distance);
+        upload_queue_flush(&uploads, &renderer, eye, vp);
+        renderer_chunks_set_view_distance(&renderer, eye, view_distance);
+        renderer_begin_pass(&renderer, RENDER_PASS_WORLD);
+        renderer_draw_chunks(&renderer, vp);
+        renderer_end_pass(&renderer);
+
+        renderer_begin_pass(&renderer, RENDER_PASS_VIEWMODEL);
+        Mat4 hand = hand_model(&view_cam);
+        renderer_draw_instanced(&renderer, &hand_gpu, &hand, 1, vp);
+        renderer_end_pass(&renderer);
+        renderer_end_frame(&renderer);
+        if (render_stats && now - stats_t0 >= RENDER_STATS_INTERVAL) {
+            stats_t0 = now;
+            log_render_stats(renderer_stats(&renderer));
+            if (use_governor) log_governor_stats(governor_stats(&governor));
+            log_upload_stats(upload_queue_stats(&uploads));
+            if (world.cache) log_cache_stats(chunk_cache_stats(&cache));
+            if (ticks.world) log_tick_stats(block_tick_stats(&ticks));
+        }
 
         app_window_swap_buffers(win);
+
+        if (autosave.thread && world_save_poll(&autosave)) {
+            if (world_save_finish(&autosave)) {
+                log_save_stats(&autosave.stats, autosave_snapshot_ms, (app_time_seconds() - autosave_t0) * 1000.0);
+            } else {
+                fprintf(stderr, "autosave: cannot write %s\n", WORLD_SAVE_PATH);
+            }
+        } else if (!autosave.thread && autosave_interval > 0.0 && now - autosave_t0 >= autosave_interval) {
+            autosave_t0 = app_time_seconds();
+            if (!world_save_start(&autosave, &world, WORLD_SAVE_PATH)) fprintf(stderr, "autosave: cannot snapshot world\n");
+            autosave_snapshot_ms = (app_time_seconds() - autosave_t0) * 1000.0;
+        }
+
+        if (first_frame) {
+            first_frame = false;
+            fprintf(stderr, "startup: first frame after %.1f ms\n", (app_time_seconds() - startup_t0) * 1000.0);
+            if (mem_stats) {
+                mem_log_report("startup");
+                mem_reset_peaks();
+            }
+        }
+    }
+
+    if (autosave.thread) world_save_finish(&autosave);
+
+    if (recorder.file) {
+        replay_writer_close(&recorder);
+        fprintf(stderr, "replay: recorded %u frames to %s\n", frames, record_path);
+    }
+    if (replay_path) {
+        fprintf(stderr, "replay: %u/%u frames, %llu ticks, camera (%.3f, %.3f, %.3f), state %016llx\n",
+            replay.frame, replay.frame_count, (unsigned long long)sim.tick,
+            sim.curr.position_feet.x, sim.curr.position_feet.y, sim.curr.position_feet.z,
+            (unsigned long long)replay_state_hash(&world, &sim.curr));
+        if (frame_times.count > 0) {
+            double sum = 0.0;
+            for (size_t i = 0; i < frame_times.count; i++) sum += frame_times.ms[i];
+            fprintf(stderr, "replay: frame time avg %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+                sum / (double)frame_times.count, frame_times_percentile(&frame_times, 50.0),
+                frame_times_percentile(&frame_times, 99.0), frame_times_percentile(&frame_times, 100.0));
+        }
+        replay_reader_close(&replay);
+    }
+
+    if (world.cache) log_cache_stats(chunk_cache_stats(&cache));
+    if (mem_stats) {
+        mem_log_report("exit");
+        ChunkSlabStats slab_stats = chunk_slab_stats();
+        log_slab_stats(&slab_stats);
     }
 
-    mesh_free(&mesh);
+    mem_free(MEM_TAG_SCRATCH, frame_times.ms);
+    upload_queue_shutdown(&uploads);
+    sim_shutdown(&sim);
+    renderer_free_mesh(&hand_gpu);
+    if (world.cache) chunk_cache_shutdown(&cache);
+    block_tick_shutdown(&ticks);
     world_shutdown(&world);
+    chunk_slab_shutdown();
+    snapshot_close(&snap);
     renderer_shutdown(&renderer);
     app_window_destroy(win);
     return 0;
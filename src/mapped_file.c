@@ -0,0 +1,98 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "mapped_file.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+bool mapped_file_open(MappedFile* out_file, const char* path) {
+    memset(out_file, 0, sizeof(*out_file));
+    out_file->fd = -1;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE map = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (!map) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(map, FILE_MAP_COPY, 0, 0, 0);
+    if (!view) {
+        CloseHandle(map);
+        CloseHandle(file);
+        return false;
+    }
+
+    out_file->data = view;
+    out_file->size = (size_t)size.QuadPart;
+    out_file->file_handle = file;
+    out_file->map_handle = map;
+    return true;
+}
+
+void mapped_file_close(MappedFile* file) {
+    if (!file) return;
+    if (file->data) UnmapViewOfFile(file->data);
+    if (file->map_handle) CloseHandle((HANDLE)file->map_handle);
+    if (file->file_handle) CloseHandle((HANDLE)file->file_handle);
+    memset(file, 0, sizeof(*file));
+    file->fd = -1;
+}
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool mapped_file_open(MappedFile* out_file, const char* path) {
+    memset(out_file, 0, sizeof(*out_file));
+    out_file->fd = -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    out_file->data = view;
+    out_file->size = (size_t)st.st_size;
+    out_file->fd = fd;
+    return true;
+}
+
+void mapped_file_close(MappedFile* file) {
+    if (!file) return;
+    if (file->data) munmap(file->data, file->size);
+    if (file->fd >= 0) close(file->fd);
+    memset(file, 0, sizeof(*file));
+    file->fd = -1;
+}
+
+#endif
@@ -2,6 +2,12 @@
 
 #include <math.h>
 
+#if defined(MATH4_SSE)
+#include <xmmintrin.h>
+#elif defined(MATH4_NEON)
+#include <arm_neon.h>
+#endif
+
 Vec3 vec3_add(Vec3 a, Vec3 b) { return (Vec3){ a.x + b.x, a.y + b.y, a.z + b.z }; }
 Vec3 vec3_sub(Vec3 a, Vec3 b) { return (Vec3){ a.x - b.x, a.y - b.y, a.z - b.z }; }
 Vec3 vec3_scale(Vec3 v, float s) { return (Vec3){ v.x * s, v.y * s, v.z * s }; }
@@ -14,6 +20,47 @@ Vec3 vec3_norm(Vec3 v) {
     return vec3_scale(v, 1.0f / l);
 }
 
+void vec3_add_p(Vec3* out, const Vec3* a, const Vec3* b) {
+    out->x = a->x + b->x;
+    out->y = a->y + b->y;
+    out->z = a->z + b->z;
+}
+
+void vec3_sub_p(Vec3* out, const Vec3* a, const Vec3* b) {
+    out->x = a->x - b->x;
+    out->y = a->y - b->y;
+    out->z = a->z - b->z;
+}
+
+void vec3_scale_p(Vec3* out, const Vec3* v, float s) {
+    out->x = v->x * s;
+    out->y = v->y * s;
+    out->z = v->z * s;
+}
+
+void vec3_madd_p(Vec3* io, const Vec3* v, float s) {
+    io->x += v->x * s;
+    io->y += v->y * s;
+    io->z += v->z * s;
+}
+
+void vec3_cross_p(Vec3* out, const Vec3* a, const Vec3* b) {
+    Vec3 r = { a->y * b->z - a->z * b->y, a->z * b->x - a->x * b->z, a->x * b->y - a->y * b->x };
+    *out = r;
+}
+
+void vec3_norm_p(Vec3* io) {
+    float l2 = io->x * io->x + io->y * io->y + io->z * io->z;
+    if (l2 < 1e-16f) {
+        io->x = io->y = io->z = 0.0f;
+        return;
+    }
+    float inv = 1.0f / sqrtf(l2);
+    io->x *= inv;
+    io->y *= inv;
+    io->z *= inv;
+}
+
 Mat4 mat4_identity(void) {
     Mat4 m = { 0 };
     m.m[0] = 1.0f;
@@ -23,20 +70,247 @@ Mat4 mat4_identity(void) {
     return m;
 }
 
-Mat4 mat4_mul(Mat4 a, Mat4 b) {
+void mat4_mul_ref(Mat4* out, const Mat4* a, const Mat4* b) {
     Mat4 r = { 0 };
     for (int c = 0; c < 4; c++) {
         for (int r0 = 0; r0 < 4; r0++) {
             r.m[c * 4 + r0] =
-                a.m[0 * 4 + r0] * b.m[c * 4 + 0] +
-                a.m[1 * 4 + r0] * b.m[c * 4 + 1] +
-                a.m[2 * 4 + r0] * b.m[c * 4 + 2] +
-                a.m[3 * 4 + r0] * b.m[c * 4 + 3];
+                a->m[0 * 4 + r0] * b->m[c * 4 + 0] +
+                a->m[1 * 4 + r0] * b->m[c * 4 + 1] +
+                a->m[2 * 4 + r0] * b->m[c * 4 + 2] +
+                a->m[3 * 4 + r0] * b->m[c * 4 + 3];
         }
     }
+    *out = r;
+}
+
+Vec4 mat4_mul_vec4_ref(const Mat4* m, Vec4 v) {
+    const float* e = m->m;
+    Vec4 r;
+    r.x = e[0] * v.x + e[4] * v.y + e[8] * v.z + e[12] * v.w;
+    r.y = e[1] * v.x + e[5] * v.y + e[9] * v.z + e[13] * v.w;
+    r.z = e[2] * v.x + e[6] * v.y + e[10] * v.z + e[14] * v.w;
+    r.w = e[3] * v.x + e[7] * v.y + e[11] * v.z + e[15] * v.w;
     return r;
 }
 
+void mat4_transform_points_ref(const Mat4* m, const Vec3* points, Vec4* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        Vec4 p = { points[i].x, points[i].y, points[i].z, 1.0f };
+        out[i] = mat4_mul_vec4_ref(m, p);
+    }
+}
+
+size_t aabb_cull_planes_ref(const Vec4 planes[6], const Vec3* mins, const Vec3* maxs, uint8_t* out_visible, size_t count) {
+    size_t visible = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t inside = 1;
+        for (int p = 0; p < 6; p++) {
+            const Vec4* pl = &planes[p];
+            float px = pl->x >= 0.0f ? maxs[i].x : mins[i].x;
+            float py = pl->y >= 0.0f ? maxs[i].y : mins[i].y;
+            float pz = pl->z >= 0.0f ? maxs[i].z : mins[i].z;
+            if (pl->x * px + pl->y * py + pl->z * pz + pl->w < 0.0f) {
+                inside = 0;
+                break;
+            }
+        }
+        out_visible[i] = inside;
+        visible += inside;
+    }
+    return visible;
+}
+
+#if defined(MATH4_SSE)
+
+void mat4_mul_p(Mat4* out, const Mat4* a, const Mat4* b) {
+    __m128 a0 = _mm_loadu_ps(a->m + 0);
+    __m128 a1 = _mm_loadu_ps(a->m + 4);
+    __m128 a2 = _mm_loadu_ps(a->m + 8);
+    __m128 a3 = _mm_loadu_ps(a->m + 12);
+    __m128 r[4];
+    for (int c = 0; c < 4; c++) {
+        const float* bc = b->m + c * 4;
+        __m128 v = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+        v = _mm_add_ps(v, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+        v = _mm_add_ps(v, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+        v = _mm_add_ps(v, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+        r[c] = v;
+    }
+    _mm_storeu_ps(out->m + 0, r[0]);
+    _mm_storeu_ps(out->m + 4, r[1]);
+    _mm_storeu_ps(out->m + 8, r[2]);
+    _mm_storeu_ps(out->m + 12, r[3]);
+}
+
+Vec4 mat4_mul_vec4(const Mat4* m, Vec4 v) {
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(m->m + 0), _mm_set1_ps(v.x));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m->m + 4), _mm_set1_ps(v.y)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m->m + 8), _mm_set1_ps(v.z)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m->m + 12), _mm_set1_ps(v.w)));
+    Vec4 out;
+    _mm_storeu_ps(&out.x, r);
+    return out;
+}
+
+void mat4_transform_points(const Mat4* m, const Vec3* points, Vec4* out, size_t count) {
+    __m128 c0 = _mm_loadu_ps(m->m + 0);
+    __m128 c1 = _mm_loadu_ps(m->m + 4);
+    __m128 c2 = _mm_loadu_ps(m->m + 8);
+    __m128 c3 = _mm_loadu_ps(m->m + 12);
+    for (size_t i = 0; i < count; i++) {
+        __m128 r = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(points[i].x)));
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(points[i].y)));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(points[i].z)));
+        _mm_storeu_ps(&out[i].x, r);
+    }
+}
+
+size_t aabb_cull_planes(const Vec4 planes[6], const Vec3* mins, const Vec3* maxs, uint8_t* out_visible, size_t count) {
+    __m128 px[2], py[2], pz[2], pw[2];
+    px[0] = _mm_setr_ps(planes[0].x, planes[1].x, planes[2].x, planes[3].x);
+    py[0] = _mm_setr_ps(planes[0].y, planes[1].y, planes[2].y, planes[3].y);
+    pz[0] = _mm_setr_ps(planes[0].z, planes[1].z, planes[2].z, planes[3].z);
+    pw[0] = _mm_setr_ps(planes[0].w, planes[1].w, planes[2].w, planes[3].w);
+    px[1] = _mm_setr_ps(planes[4].x, planes[5].x, 0.0f, 0.0f);
+    py[1] = _mm_setr_ps(planes[4].y, planes[5].y, 0.0f, 0.0f);
+    pz[1] = _mm_setr_ps(planes[4].z, planes[5].z, 0.0f, 0.0f);
+    pw[1] = _mm_setr_ps(planes[4].w, planes[5].w, 1.0f, 1.0f);
+    __m128 zero = _mm_setzero_ps();
+
+    size_t visible = 0;
+    for (size_t i = 0; i < count; i++) {
+        __m128 mnx = _mm_set1_ps(mins[i].x), mxx = _mm_set1_ps(maxs[i].x);
+        __m128 mny = _mm_set1_ps(mins[i].y), mxy = _mm_set1_ps(maxs[i].y);
+        __m128 mnz = _mm_set1_ps(mins[i].z), mxz = _mm_set1_ps(maxs[i].z);
+        int outside = 0;
+        for (int k = 0; k < 2; k++) {
+            __m128 d = pw[k];
+            d = _mm_add_ps(d, _mm_max_ps(_mm_mul_ps(px[k], mnx), _mm_mul_ps(px[k], mxx)));
+            d = _mm_add_ps(d, _mm_max_ps(_mm_mul_ps(py[k], mny), _mm_mul_ps(py[k], mxy)));
+            d = _mm_add_ps(d, _mm_max_ps(_mm_mul_ps(pz[k], mnz), _mm_mul_ps(pz[k], mxz)));
+            outside |= _mm_movemask_ps(_mm_cmplt_ps(d, zero));
+        }
+        out_visible[i] = outside ? 0 : 1;
+        visible += outside ? 0 : 1;
+    }
+    return visible;
+}
+
+#elif defined(MATH4_NEON)
+
+void mat4_mul_p(Mat4* out, const Mat4* a, const Mat4* b) {
+    float32x4_t a0 = vld1q_f32(a->m + 0);
+    float32x4_t a1 = vld1q_f32(a->m + 4);
+    float32x4_t a2 = vld1q_f32(a->m + 8);
+    float32x4_t a3 = vld1q_f32(a->m + 12);
+    float32x4_t r[4];
+    for (int c = 0; c < 4; c++) {
+        const float* bc = b->m + c * 4;
+        float32x4_t v = vmulq_n_f32(a0, bc[0]);
+        v = vmlaq_n_f32(v, a1, bc[1]);
+        v = vmlaq_n_f32(v, a2, bc[2]);
+        v = vmlaq_n_f32(v, a3, bc[3]);
+        r[c] = v;
+    }
+    vst1q_f32(out->m + 0, r[0]);
+    vst1q_f32(out->m + 4, r[1]);
+    vst1q_f32(out->m + 8, r[2]);
+    vst1q_f32(out->m + 12, r[3]);
+}
+
+Vec4 mat4_mul_vec4(const Mat4* m, Vec4 v) {
+    float32x4_t r = vmulq_n_f32(vld1q_f32(m->m + 0), v.x);
+    r = vmlaq_n_f32(r, vld1q_f32(m->m + 4), v.y);
+    r = vmlaq_n_f32(r, vld1q_f32(m->m + 8), v.z);
+    r = vmlaq_n_f32(r, vld1q_f32(m->m + 12), v.w);
+    Vec4 out;
+    vst1q_f32(&out.x, r);
+    return out;
+}
+
+void mat4_transform_points(const Mat4* m, const Vec3* points, Vec4* out, size_t count) {
+    float32x4_t c0 = vld1q_f32(m->m + 0);
+    float32x4_t c1 = vld1q_f32(m->m + 4);
+    float32x4_t c2 = vld1q_f32(m->m + 8);
+    float32x4_t c3 = vld1q_f32(m->m + 12);
+    for (size_t i = 0; i < count; i++) {
+        float32x4_t r = vmlaq_n_f32(c3, c0, points[i].x);
+        r = vmlaq_n_f32(r, c1, points[i].y);
+        r = vmlaq_n_f32(r, c2, points[i].z);
+        vst1q_f32(&out[i].x, r);
+    }
+}
+
+size_t aabb_cull_planes(const Vec4 planes[6], const Vec3* mins, const Vec3* maxs, uint8_t* out_visible, size_t count) {
+    float sx[8] = { planes[0].x, planes[1].x, planes[2].x, planes[3].x, planes[4].x, planes[5].x, 0.0f, 0.0f };
+    float sy[8] = { planes[0].y, planes[1].y, planes[2].y, planes[3].y, planes[4].y, planes[5].y, 0.0f, 0.0f };
+    float sz[8] = { planes[0].z, planes[1].z, planes[2].z, planes[3].z, planes[4].z, planes[5].z, 0.0f, 0.0f };
+    float sw[8] = { planes[0].w, planes[1].w, planes[2].w, planes[3].w, planes[4].w, planes[5].w, 1.0f, 1.0f };
+    float32x4_t zero = vdupq_n_f32(0.0f);
+
+    size_t visible = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (int k = 0; k < 2; k++) {
+            float32x4_t px = vld1q_f32(sx + k * 4);
+            float32x4_t py = vld1q_f32(sy + k * 4);
+            float32x4_t pz = vld1q_f32(sz + k * 4);
+            float32x4_t d = vld1q_f32(sw + k * 4);
+            d = vaddq_f32(d, vmaxq_f32(vmulq_n_f32(px, mins[i].x), vmulq_n_f32(px, maxs[i].x)));
+            d = vaddq_f32(d, vmaxq_f32(vmulq_n_f32(py, mins[i].y), vmulq_n_f32(py, maxs[i].y)));
+            d = vaddq_f32(d, vmaxq_f32(vmulq_n_f32(pz, mins[i].z), vmulq_n_f32(pz, maxs[i].z)));
+            outside = vorrq_u32(outside, vcltq_f32(d, zero));
+        }
+        uint32x2_t o2 = vorr_u32(vget_low_u32(outside), vget_high_u32(outside));
+        uint8_t inside = (vget_lane_u32(o2, 0) | vget_lane_u32(o2, 1)) ? 0 : 1;
+        out_visible[i] = inside;
+        visible += inside;
+    }
+    return visible;
+}
+
+#else
+
+void mat4_mul_p(Mat4* out, const Mat4* a, const Mat4* b) { mat4_mul_ref(out, a, b); }
+Vec4 mat4_mul_vec4(const Mat4* m, Vec4 v) { return mat4_mul_vec4_ref(m, v); }
+
+void mat4_transform_points(const Mat4* m, const Vec3* points, Vec4* out, size_t count) {
+    mat4_transform_points_ref(m, points, out, count);
+}
+
+size_t aabb_cull_planes(const Vec4 planes[6], const Vec3* mins, const Vec3* maxs, uint8_t* out_visible, size_t count) {
+    return aabb_cull_planes_ref(planes, mins, maxs, out_visible, count);
+}
+
+#endif
+
+Mat4 mat4_mul(Mat4 a, Mat4 b) {
+    Mat4 r;
+    mat4_mul_p(&r, &a, &b);
+    return r;
+}
+
+void mat4_frustum_planes(const Mat4* view_proj, Vec4 out_planes[6]) {
+    const float* e = view_proj->m;
+    for (int i = 0; i < 3; i++) {
+        Vec4 lo = { e[3] + e[i], e[7] + e[4 + i], e[11] + e[8 + i], e[15] + e[12 + i] };
+        Vec4 hi = { e[3] - e[i], e[7] - e[4 + i], e[11] - e[8 + i], e[15] - e[12 + i] };
+        out_planes[i * 2 + 0] = lo;
+        out_planes[i * 2 + 1] = hi;
+    }
+    for (int p = 0; p < 6; p++) {
+        Vec4* pl = &out_planes[p];
+        float l = sqrtf(pl->x * pl->x + pl->y * pl->y + pl->z * pl->z);
+        if (l < 1e-8f) continue;
+        float inv = 1.0f / l;
+        pl->x *= inv;
+        pl->y *= inv;
+        pl->z *= inv;
+        pl->w *= inv;
+    }
+}
+
 Mat4 mat4_perspective(float fov_y_radians, float aspect, float z_near, float z_far) {
     float f = 1.0f / tanf(fov_y_radians * 0.5f);
     Mat4 m = { 0 };
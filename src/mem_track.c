@@ -0,0 +1,145 @@
+#include "mem_track.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MEM_HEADER_BYTES 16
+
+typedef struct MemCounters {
+    atomic_size_t current;
+    atomic_size_t peak;
+    atomic_uint_least64_t allocs;
+    atomic_uint_least64_t reallocs;
+    atomic_uint_least64_t frees;
+    atomic_size_t budget;
+} MemCounters;
+
+static MemCounters g_mem[MEM_TAG_COUNT];
+
+static const char* g_mem_tag_names[MEM_TAG_COUNT] = {
+    "world",
+    "mesh",
+    "scratch",
+    "texture",
+    "gpu_mirror",
+};
+
+static void note_grow(MemCounters* c, size_t bytes) {
+    size_t now = atomic_fetch_add(&c->current, bytes) + bytes;
+    size_t peak = atomic_load(&c->peak);
+    while (now > peak && !atomic_compare_exchange_weak(&c->peak, &peak, now)) {
+    }
+}
+
+static void* header_to_user(void* base, size_t bytes) {
+    memcpy(base, &bytes, sizeof(bytes));
+    return (uint8_t*)base + MEM_HEADER_BYTES;
+}
+
+static void* user_to_header(void* ptr, size_t* out_bytes) {
+    uint8_t* base = (uint8_t*)ptr - MEM_HEADER_BYTES;
+    memcpy(out_bytes, base, sizeof(*out_bytes));
+    return base;
+}
+
+void* mem_alloc(MemTag tag, size_t bytes) {
+    if (bytes > SIZE_MAX - MEM_HEADER_BYTES) return NULL;
+    void* base = malloc(bytes + MEM_HEADER_BYTES);
+    if (!base) return NULL;
+    MemCounters* c = &g_mem[tag];
+    note_grow(c, bytes);
+    atomic_fetch_add(&c->allocs, 1);
+    return header_to_user(base, bytes);
+}
+
+void* mem_calloc(MemTag tag, size_t count, size_t size) {
+    if (size && count > (SIZE_MAX - MEM_HEADER_BYTES) / size) return NULL;
+    size_t bytes = count * size;
+    void* base = calloc(1, bytes + MEM_HEADER_BYTES);
+    if (!base) return NULL;
+    MemCounters* c = &g_mem[tag];
+    note_grow(c, bytes);
+    atomic_fetch_add(&c->allocs, 1);
+    return header_to_user(base, bytes);
+}
+
+void* mem_realloc(MemTag tag, void* ptr, size_t bytes) {
+    if (!ptr) return mem_alloc(tag, bytes);
+    if (bytes > SIZE_MAX - MEM_HEADER_BYTES) return NULL;
+
+    size_t old_bytes;
+    void* old_base = user_to_header(ptr, &old_bytes);
+    void* base = realloc(old_base, bytes + MEM_HEADER_BYTES);
+    if (!base) return NULL;
+
+    MemCounters* c = &g_mem[tag];
+    atomic_fetch_add(&c->reallocs, 1);
+    if (bytes >= old_bytes) note_grow(c, bytes - old_bytes);
+    else atomic_fetch_sub(&c->current, old_bytes - bytes);
+    return header_to_user(base, bytes);
+}
+
+void mem_free(MemTag tag, void* ptr) {
+    if (!ptr) return;
+    size_t bytes;
+    void* base = user_to_header(ptr, &bytes);
+    MemCounters* c = &g_mem[tag];
+    atomic_fetch_sub(&c->current, bytes);
+    atomic_fetch_add(&c->frees, 1);
+    free(base);
+}
+
+void mem_set_budget(MemTag tag, size_t bytes) {
+    atomic_store(&g_mem[tag].budget, bytes);
+}
+
+bool mem_over_budget(MemTag tag) {
+    size_t budget = atomic_load(&g_mem[tag].budget);
+    return budget && atomic_load(&g_mem[tag].current) > budget;
+}
+
+MemTagStats mem_tag_stats(MemTag tag) {
+    MemTagStats s;
+    const MemCounters* c = &g_mem[tag];
+    s.current_bytes = atomic_load(&c->current);
+    s.peak_bytes = atomic_load(&c->peak);
+    s.alloc_count = atomic_load(&c->allocs);
+    s.realloc_count = atomic_load(&c->reallocs);
+    s.free_count = atomic_load(&c->frees);
+    s.budget_bytes = atomic_load(&c->budget);
+    return s;
+}
+
+size_t mem_total_bytes(void) {
+    size_t total = 0;
+    for (int t = 0; t < MEM_TAG_COUNT; t++) total += atomic_load(&g_mem[t].current);
+    return total;
+}
+
+void mem_reset_peaks(void) {
+    for (int t = 0; t < MEM_TAG_COUNT; t++) atomic_store(&g_mem[t].peak, atomic_load(&g_mem[t].current));
+}
+
+const char* mem_tag_name(MemTag tag) {
+    if ((int)tag < 0 || tag >= MEM_TAG_COUNT) return "?";
+    return g_mem_tag_names[tag];
+}
+
+void mem_log_report(const char* label) {
+    fprintf(stderr, "memory (%s): %.1f KiB total\n", label, (double)mem_total_bytes() / 1024.0);
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        MemTagStats s = mem_tag_stats((MemTag)t);
+        fprintf(stderr, "  %-10s %10.1f KiB  peak %10.1f KiB  %llu allocs, %llu reallocs, %llu live",
+            mem_tag_name((MemTag)t), (double)s.current_bytes / 1024.0, (double)s.peak_bytes / 1024.0,
+            (unsigned long long)s.alloc_count, (unsigned long long)s.realloc_count, (unsigned long long)(s.alloc_count - s.free_count));
+        if (s.budget_bytes) {
+            fprintf(stderr, "  budget %.1f KiB%s", (double)s.budget_bytes / 1024.0,
+                s.current_bytes > s.budget_bytes ? " EXCEEDED" : "");
+        }
+        fprintf(stderr, "\n");
+    }
+}
@@ -1,11 +1,12 @@
 #include "mesh.h"
 
-#include <stdlib.h>
+#include "mem_track.h"
 
 void mesh_free(Mesh* mesh) {
     if (!mesh) return;
-    free(mesh->vertices);
+    if (!mesh->external) mem_free(MEM_TAG_MESH, mesh->vertices);
     mesh->vertices = NULL;
     mesh->vertex_count = 0;
+    mesh->external = false;
 }
 
@@ -1,6 +1,11 @@
 #include "renderer.h"
 
+#include "block.h"
 #include "gl_loader.h"
+#include "gl_state.h"
+#include "mem_track.h"
+#include "shader_cache.h"
+#include "stream_buffer.h"
 
 #include <math.h>
 #include <stdbool.h>
@@ -8,105 +13,72 @@
 #include <stdlib.h>
 #include <string.h>
 
-static uint32_t compile_shader(uint32_t type, const char* src) {
-    GLuint s = glCreateShader_(type);
-    const GLchar* strings[] = { (const GLchar*)src };
-    glShaderSource_(s, 1, strings, NULL);
-    glCompileShader_(s);
-    GLint ok = 0;
-    glGetShaderiv_(s, GL_COMPILE_STATUS, &ok);
-    if (!ok) {
-        glDeleteShader_(s);
-        return 0;
-    }
-    return (uint32_t)s;
+#define STREAM_ALIGN 16
+#define INSTANCE_BATCH (STREAM_BUFFER_DEFAULT_SIZE / 4 / sizeof(Mat4))
+
+static void bind_vertex_layout(size_t base) {
+    GLsizei stride = (GLsizei)(MESH_VERTEX_FLOATS * sizeof(float));
+    glEnableVertexAttribArray_(0);
+    glVertexAttribPointer_(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)base);
+    glEnableVertexAttribArray_(1);
+    glVertexAttribPointer_(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(base + 3 * sizeof(float)));
+    glEnableVertexAttribArray_(2);
+    glVertexAttribPointer_(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(base + 5 * sizeof(float)));
+    glEnableVertexAttribArray_(3);
+    glVertexAttribPointer_(3, 2, GL_FLOAT, GL_FALSE, stride, (void*)(base + 8 * sizeof(float)));
 }
 
-static uint32_t link_program(uint32_t vs, uint32_t fs) {
-    GLuint p = glCreateProgram_();
-    glAttachShader_(p, vs);
-    glAttachShader_(p, fs);
-    glLinkProgram_(p);
-    GLint ok = 0;
-    glGetProgramiv_(p, GL_LINK_STATUS, &ok);
-    if (!ok) {
-        glDeleteProgram_(p);
-        return 0;
+static void bind_instance_layout(size_t base) {
+    GLsizei stride = (GLsizei)sizeof(Mat4);
+    for (GLuint col = 0; col < 4; col++) {
+        GLuint loc = 4 + col;
+        glEnableVertexAttribArray_(loc);
+        glVertexAttribPointer_(loc, 4, GL_FLOAT, GL_FALSE, stride, (void*)(base + col * 4 * sizeof(float)));
+        glVertexAttribDivisor_(loc, 1);
     }
-    return (uint32_t)p;
 }
 
-static void atlas_put_tile_rgba(uint32_t* rgba, int atlas_w, int x0, int y0, const uint32_t* tile, int tile_w, int tile_h) {
-    for (int y = 0; y < tile_h; y++) {
-        uint32_t* dst = rgba + (y0 + y) * atlas_w + x0;
-        const uint32_t* src = tile + y * tile_w;
-        memcpy(dst, src, (size_t)tile_w * sizeof(uint32_t));
-    }
+static bool stream_upload(Renderer* r, const void* data, size_t bytes, size_t* out_offset) {
+    if (!stream_buffer_write(&r->stream, data, bytes, STREAM_ALIGN, out_offset)) return false;
+    r->frame_stats.upload_bytes += bytes;
+    return true;
 }
 
-static uint32_t pack_rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-    return (uint32_t)(r) | ((uint32_t)g << 8u) | ((uint32_t)b << 16u) | ((uint32_t)a << 24u);
+static void count_draw(Renderer* r, size_t vertex_count, size_t instances) {
+    r->frame_stats.draw_calls++;
+    r->frame_stats.triangles += (uint64_t)(vertex_count / 3) * instances;
 }
 
-static void make_noise_tile(uint32_t* out_rgba, int w, int h, uint32_t c0, uint32_t c1, uint32_t c2) {
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            uint32_t pick = (uint32_t)((x * 1973 + y * 9277 + x * y * 26699) & 7);
-            uint32_t c = (pick < 4) ? c0 : (pick < 6 ? c1 : c2);
-            out_rgba[y * w + x] = c;
-        }
+static void copy_to_buffer(Renderer* r, GLuint dst, size_t dst_offset, const void* data, size_t bytes) {
+    size_t src_offset = 0;
+    if (stream_upload(r, data, bytes, &src_offset)) {
+        gl_state_bind_buffer(GL_COPY_READ_BUFFER, (GLuint)r->stream.buffer);
+        gl_state_bind_buffer(GL_COPY_WRITE_BUFFER, dst);
+        glCopyBufferSubData_(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)src_offset, (GLintptr)dst_offset, (GLsizeiptr)bytes);
+        return;
     }
+    gl_state_bind_buffer(GL_COPY_WRITE_BUFFER, dst);
+    glBufferSubData_(GL_COPY_WRITE_BUFFER, (GLintptr)dst_offset, (GLsizeiptr)bytes, data);
+    r->frame_stats.upload_bytes += bytes;
 }
 
-static uint32_t make_texture_atlas(void) {
-    const int tile = 16;
-    const int tiles = 4;
-    const int atlas_w = tile * tiles;
-    const int atlas_h = tile;
+#define CHUNK_POOL_GRANULARITY 384
+#define CHUNK_POOL_INITIAL_VERTICES (1u << 18)
 
-    uint32_t* rgba = (uint32_t*)malloc((size_t)atlas_w * (size_t)atlas_h * sizeof(uint32_t));
-    if (!rgba) return 0;
-    memset(rgba, 0, (size_t)atlas_w * (size_t)atlas_h * sizeof(uint32_t));
-
-    uint32_t grass_top[16 * 16];
-    uint32_t grass_side[16 * 16];
-    uint32_t dirt[16 * 16];
-    uint32_t stone[16 * 16];
-
-    uint32_t g0 = pack_rgba(0x52, 0xA1, 0x3B, 0xFF);
-    uint32_t g1 = pack_rgba(0x6B, 0xB7, 0x4D, 0xFF);
-    uint32_t g2 = pack_rgba(0x3F, 0x8F, 0x2E, 0xFF);
-    make_noise_tile(grass_top, tile, tile, g0, g1, g2);
-
-    uint32_t d0 = pack_rgba(0x8A, 0x6A, 0x3D, 0xFF);
-    uint32_t d1 = pack_rgba(0x7A, 0x5D, 0x34, 0xFF);
-    uint32_t d2 = pack_rgba(0x9A, 0x77, 0x46, 0xFF);
-    make_noise_tile(dirt, tile, tile, d0, d1, d2);
-
-    uint32_t s0 = pack_rgba(0x86, 0x86, 0x86, 0xFF);
-    uint32_t s1 = pack_rgba(0x74, 0x74, 0x74, 0xFF);
-    uint32_t s2 = pack_rgba(0x96, 0x96, 0x96, 0xFF);
-    make_noise_tile(stone, tile, tile, s0, s1, s2);
-
-    for (int y = 0; y < tile; y++) {
-        for (int x = 0; x < tile; x++) {
-            bool top_band = (y < 6);
-            uint32_t base = top_band ? grass_top[y * tile + x] : dirt[y * tile + x];
-            if (top_band && ((x + y) & 7) == 0) {
-                base = pack_rgba(0x7A, 0xC9, 0x63, 0xFF);
-            }
-            grass_side[y * tile + x] = base;
-        }
-    }
+static void bind_origin_layout(void) {
+    glEnableVertexAttribArray_(4);
+    glVertexAttribPointer_(4, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(Vec4), (void*)0);
+    glVertexAttribDivisor_(4, 1);
+}
 
-    atlas_put_tile_rgba(rgba, atlas_w, 0 * tile, 0, grass_top, tile, tile);
-    atlas_put_tile_rgba(rgba, atlas_w, 1 * tile, 0, grass_side, tile, tile);
-    atlas_put_tile_rgba(rgba, atlas_w, 2 * tile, 0, dirt, tile, tile);
-    atlas_put_tile_rgba(rgba, atlas_w, 3 * tile, 0, stone, tile, tile);
+static uint32_t make_texture_atlas(void) {
+    int atlas_w = 0, atlas_h = 0;
+    uint32_t* rgba = block_build_atlas(&atlas_w, &atlas_h);
+    if (!rgba) return 0;
 
     GLuint tex = 0;
     glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    gl_state_bind_texture_2d(tex);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
@@ -114,76 +86,116 @@ static uint32_t make_texture_atlas(void) {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlas_w, atlas_h, 0, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, rgba);
     glGenerateMipmap_(GL_TEXTURE_2D);
 
-    free(rgba);
+    mem_free(MEM_TAG_TEXTURE, rgba);
     return (uint32_t)tex;
 }
 
 bool renderer_init(Renderer* r) {
     memset(r, 0, sizeof(*r));
+    gl_state_reset();
+    r->active_pass = -1;
+    block_registry_init();
 
     const char* vs_src =
         "#version 330 core\n"
         "layout(location=0) in vec3 aPos;\n"
         "layout(location=1) in vec2 aUV;\n"
         "layout(location=2) in vec3 aN;\n"
+        "layout(location=3) in vec2 aLight;\n"
         "uniform mat4 uMVP;\n"
         "out vec2 vUV;\n"
         "out vec3 vN;\n"
-        "void main(){ vUV=aUV; vN=aN; gl_Position=uMVP*vec4(aPos,1.0); }\n";
+        "out vec2 vLight;\n"
+        "void main(){ vUV=aUV; vN=aN; vLight=aLight; gl_Position=uMVP*vec4(aPos,1.0); }\n";
 
     const char* fs_src =
         "#version 330 core\n"
         "in vec2 vUV;\n"
         "in vec3 vN;\n"
+        "in vec2 vLight;\n"
         "uniform sampler2D uTex;\n"
         "uniform vec3 uLightDir;\n"
         "out vec4 FragColor;\n"
         "void main(){\n"
         "  vec3 n = normalize(vN);\n"
         "  float ndl = max(dot(n, normalize(uLightDir)), 0.2);\n"
+        "  float lit = max(vLight.x, vLight.y);\n"
+        "  float amb = 0.08 + 0.92*lit*lit;\n"
         "  vec4 c = texture(uTex, vUV);\n"
-        "  FragColor = vec4(c.rgb*ndl, c.a);\n"
+        "  FragColor = vec4(c.rgb*ndl*amb, c.a);\n"
         "}\n";
 
-    uint32_t vs = compile_shader(GL_VERTEX_SHADER, vs_src);
-    uint32_t fs = compile_shader(GL_FRAGMENT_SHADER, fs_src);
-    if (!vs || !fs) return false;
+    const char* inst_vs_src =
+        "#version 330 core\n"
+        "layout(location=0) in vec3 aPos;\n"
+        "layout(location=1) in vec2 aUV;\n"
+        "layout(location=2) in vec3 aN;\n"
+        "layout(location=3) in vec2 aLight;\n"
+        "layout(location=4) in mat4 aModel;\n"
+        "uniform mat4 uViewProj;\n"
+        "out vec2 vUV;\n"
+        "out vec3 vN;\n"
+        "out vec2 vLight;\n"
+        "void main(){ vUV=aUV; vN=mat3(aModel)*aN; vLight=aLight; gl_Position=uViewProj*(aModel*vec4(aPos,1.0)); }\n";
 
-    uint32_t prog = link_program(vs, fs);
-    glDeleteShader_(vs);
-    glDeleteShader_(fs);
-    if (!prog) return false;
+    const char* chunk_vs_src =
+        "#version 330 core\n"
+        "layout(location=0) in vec3 aPos;\n"
+        "layout(location=1) in vec2 aUV;\n"
+        "layout(location=2) in vec3 aN;\n"
+        "layout(location=3) in vec2 aLight;\n"
+        "layout(location=4) in vec3 aOrigin;\n"
+        "uniform mat4 uViewProj;\n"
+        "out vec2 vUV;\n"
+        "out vec3 vN;\n"
+        "out vec2 vLight;\n"
+        "void main(){ vUV=aUV; vN=aN; vLight=aLight; gl_Position=uViewProj*vec4(aPos+aOrigin,1.0); }\n";
 
-    r->program = prog;
+    r->program = shader_cache_build_program("voxel", vs_src, fs_src, &r->shader_stats);
+    if (!r->program) return false;
+    r->instanced_program = shader_cache_build_program("voxel_instanced", inst_vs_src, fs_src, &r->shader_stats);
+    if (!r->instanced_program) return false;
+    r->chunks.program = shader_cache_build_program("voxel_chunk", chunk_vs_src, fs_src, &r->shader_stats);
+    if (!r->chunks.program) return false;
 
     GLuint vao = 0, vbo = 0;
     glGenVertexArrays_(1, &vao);
-    glBindVertexArray_(vao);
+    gl_state_bind_vertex_array(vao);
     glGenBuffers_(1, &vbo);
-    glBindBuffer_(GL_ARRAY_BUFFER, vbo);
+    gl_state_bind_buffer(GL_ARRAY_BUFFER, vbo);
     glBufferData_(GL_ARRAY_BUFFER, 0, NULL, GL_DYNAMIC_DRAW);
-
-    GLsizei stride = (GLsizei)(8 * sizeof(float));
-    glEnableVertexAttribArray_(0);
-    glVertexAttribPointer_(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray_(1);
-    glVertexAttribPointer_(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray_(2);
-    glVertexAttribPointer_(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(5 * sizeof(float)));
+    bind_vertex_layout(0);
 
     r->vao = (uint32_t)vao;
     r->vbo = (uint32_t)vbo;
 
+    if (!stream_buffer_init(&r->stream, STREAM_BUFFER_DEFAULT_SIZE)) return false;
+
     r->texture_atlas = make_texture_atlas();
     if (!r->texture_atlas) return false;
 
-    glUseProgram_(r->program);
     int u_tex = glGetUniformLocation_(r->program, "uTex");
     r->u_mvp = glGetUniformLocation_(r->program, "uMVP");
     r->u_light_dir = glGetUniformLocation_(r->program, "uLightDir");
-    glUniform1i_(u_tex, 0);
+    gl_state_uniform_1i(r->program, u_tex, 0);
     float light[3] = { -0.6f, 1.0f, -0.2f };
-    glUniform3fv_(r->u_light_dir, 1, light);
+    gl_state_uniform_3fv(r->program, r->u_light_dir, light);
+
+    r->u_inst_view_proj = glGetUniformLocation_(r->instanced_program, "uViewProj");
+    gl_state_uniform_1i(r->instanced_program, glGetUniformLocation_(r->instanced_program, "uTex"), 0);
+    gl_state_uniform_3fv(r->instanced_program, glGetUniformLocation_(r->instanced_program, "uLightDir"), light);
+
+    r->chunks.u_view_proj = glGetUniformLocation_(r->chunks.program, "uViewProj");
+    gl_state_uniform_1i(r->chunks.program, glGetUniformLocation_(r->chunks.program, "uTex"), 0);
+    gl_state_uniform_3fv(r->chunks.program, glGetUniformLocation_(r->chunks.program, "uLightDir"), light);
+    r->chunks.multi_draw = gl_has_multi_draw_indirect();
+
+    if (gl_has_timer_query()) {
+        GLuint queries[RENDER_TIMER_LATENCY * RENDER_PASS_COUNT];
+        glGenQueries_(RENDER_TIMER_LATENCY * RENDER_PASS_COUNT, queries);
+        memcpy(r->timer_queries, queries, sizeof(queries));
+        r->timers_enabled = true;
+    }
 
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
@@ -193,23 +205,36 @@ bool renderer_init(Renderer* r) {
     return true;
 }
 
+static void chunk_pool_destroy(ChunkPool* p) {
+    gl_state_delete_buffer((GLuint)p->vbo);
+    gl_state_delete_buffer((GLuint)p->origin_vbo);
+    gl_state_delete_vertex_array((GLuint)p->vao);
+    gl_state_delete_program(p->program);
+    mem_free(MEM_TAG_GPU_MIRROR, p->free_ranges);
+    mem_free(MEM_TAG_GPU_MIRROR, p->slots);
+    mem_free(MEM_TAG_GPU_MIRROR, p->slot_capacity);
+    mem_free(MEM_TAG_GPU_MIRROR, p->origins);
+    mem_free(MEM_TAG_GPU_MIRROR, p->mins);
+    mem_free(MEM_TAG_GPU_MIRROR, p->maxs);
+    mem_free(MEM_TAG_GPU_MIRROR, p->visible);
+    mem_free(MEM_TAG_GPU_MIRROR, p->commands);
+    memset(p, 0, sizeof(*p));
+}
+
 void renderer_shutdown(Renderer* r) {
     if (!r) return;
-    if (r->texture_atlas) {
-        GLuint t = (GLuint)r->texture_atlas;
-        glDeleteTextures(1, &t);
-    }
-    if (r->vbo) {
-        GLuint b = (GLuint)r->vbo;
-        glDeleteBuffers_(1, &b);
-    }
-    if (r->vao) {
-        GLuint a = (GLuint)r->vao;
-        glDeleteVertexArrays_(1, &a);
-    }
-    if (r->program) {
-        glDeleteProgram_(r->program);
+    chunk_pool_destroy(&r->chunks);
+    stream_buffer_shutdown(&r->stream);
+    if (r->timers_enabled) {
+        GLuint queries[RENDER_TIMER_LATENCY * RENDER_PASS_COUNT];
+        memcpy(queries, r->timer_queries, sizeof(queries));
+        glDeleteQueries_(RENDER_TIMER_LATENCY * RENDER_PASS_COUNT, queries);
     }
+    gl_state_delete_texture((GLuint)r->texture_atlas);
+    gl_state_delete_buffer((GLuint)r->vbo);
+    gl_state_delete_vertex_array((GLuint)r->vao);
+    gl_state_delete_program(r->program);
+    gl_state_delete_program(r->instanced_program);
     memset(r, 0, sizeof(*r));
 }
 
@@ -220,14 +245,377 @@ void renderer_resize(int width, int height) {
 }
 
 void renderer_draw_mesh(Renderer* r, const Mesh* mesh, Mat4 mvp) {
-    glUseProgram_(r->program);
-    glUniformMatrix4fv_(r->u_mvp, 1, GL_FALSE, mvp.m);
+    gl_state_use_program(r->program);
+    gl_state_uniform_mat4(r->program, r->u_mvp, mvp.m);
+
+    gl_state_active_texture(GL_TEXTURE0);
+    gl_state_bind_texture_2d((GLuint)r->texture_atlas);
+
+    if (mesh->vertex_count == 0) return;
+    size_t bytes = mesh->vertex_count * MESH_VERTEX_FLOATS * sizeof(float);
+    size_t offset = 0;
+    gl_state_bind_vertex_array(r->vao);
+    if (stream_upload(r, mesh->vertices, bytes, &offset)) {
+        gl_state_bind_buffer(GL_ARRAY_BUFFER, (GLuint)r->stream.buffer);
+    } else {
+        offset = 0;
+        gl_state_bind_buffer(GL_ARRAY_BUFFER, (GLuint)r->vbo);
+        glBufferData_(GL_ARRAY_BUFFER, (GLsizeiptr)bytes, mesh->vertices, GL_STREAM_DRAW);
+        r->frame_stats.upload_bytes += bytes;
+    }
+    bind_vertex_layout(offset);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)mesh->vertex_count);
+    count_draw(r, mesh->vertex_count, 1);
+}
 
-    glActiveTexture_(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, (GLuint)r->texture_atlas);
+bool renderer_upload_mesh(Renderer* r, const Mesh* mesh, GpuMesh* out_mesh) {
+    memset(out_mesh, 0, sizeof(*out_mesh));
 
-    glBindVertexArray_(r->vao);
-    glBindBuffer_(GL_ARRAY_BUFFER, (GLuint)r->vbo);
-    glBufferData_(GL_ARRAY_BUFFER, (GLsizeiptr)(mesh->vertex_count * 8 * sizeof(float)), mesh->vertices, GL_STATIC_DRAW);
-    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)mesh->vertex_count);
+    GLuint vao = 0, vbo = 0;
+    glGenVertexArrays_(1, &vao);
+    gl_state_bind_vertex_array(vao);
+    glGenBuffers_(1, &vbo);
+    gl_state_bind_buffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData_(GL_ARRAY_BUFFER, (GLsizeiptr)(mesh->vertex_count * MESH_VERTEX_FLOATS * sizeof(float)), mesh->vertices, GL_STATIC_DRAW);
+    bind_vertex_layout(0);
+    r->frame_stats.upload_bytes += mesh->vertex_count * MESH_VERTEX_FLOATS * sizeof(float);
+
+    gl_state_bind_buffer(GL_ARRAY_BUFFER, (GLuint)r->stream.buffer);
+    bind_instance_layout(0);
+    gl_state_bind_vertex_array(0);
+
+    if (!vao || !vbo) {
+        gl_state_delete_buffer(vbo);
+        gl_state_delete_vertex_array(vao);
+        return false;
+    }
+
+    out_mesh->vao = (uint32_t)vao;
+    out_mesh->vbo = (uint32_t)vbo;
+    out_mesh->vertex_count = mesh->vertex_count;
+    return true;
+}
+
+void renderer_free_mesh(GpuMesh* mesh) {
+    if (!mesh) return;
+    gl_state_delete_buffer((GLuint)mesh->vbo);
+    gl_state_delete_vertex_array((GLuint)mesh->vao);
+    memset(mesh, 0, sizeof(*mesh));
+}
+
+void renderer_draw_instanced(Renderer* r, const GpuMesh* mesh, const Mat4* models, size_t count, Mat4 view_proj) {
+    if (!mesh->vao || count == 0) return;
+
+    gl_state_use_program(r->instanced_program);
+    gl_state_uniform_mat4(r->instanced_program, r->u_inst_view_proj, view_proj.m);
+
+    gl_state_active_texture(GL_TEXTURE0);
+    gl_state_bind_texture_2d((GLuint)r->texture_atlas);
+
+    gl_state_bind_vertex_array(mesh->vao);
+    for (size_t first = 0; first < count; first += INSTANCE_BATCH) {
+        size_t n = count - first < INSTANCE_BATCH ? count - first : INSTANCE_BATCH;
+        size_t bytes = n * sizeof(Mat4);
+        size_t offset = 0;
+        if (stream_upload(r, models + first, bytes, &offset)) {
+            gl_state_bind_buffer(GL_ARRAY_BUFFER, (GLuint)r->stream.buffer);
+        } else {
+            offset = 0;
+            gl_state_bind_buffer(GL_ARRAY_BUFFER, (GLuint)r->vbo);
+            glBufferData_(GL_ARRAY_BUFFER, (GLsizeiptr)bytes, models + first, GL_STREAM_DRAW);
+            r->frame_stats.upload_bytes += bytes;
+        }
+        bind_instance_layout(offset);
+        glDrawArraysInstanced_(GL_TRIANGLES, 0, (GLsizei)mesh->vertex_count, (GLsizei)n);
+        count_draw(r, mesh->vertex_count, n);
+    }
+}
+
+static bool free_range_insert(ChunkPool* p, size_t first, size_t count) {
+    if (count == 0) return true;
+
+    size_t i = 0;
+    while (i < p->free_count && p->free_ranges[i].first < first) i++;
+
+    bool joins_prev = i > 0 && p->free_ranges[i - 1].first + p->free_ranges[i - 1].count == first;
+    bool joins_next = i < p->free_count && first + count == p->free_ranges[i].first;
+    if (joins_prev && joins_next) {
+        p->free_ranges[i - 1].count += count + p->free_ranges[i].count;
+        memmove(&p->free_ranges[i], &p->free_ranges[i + 1], (p->free_count - i - 1) * sizeof(VertexRange));
+        p->free_count--;
+        return true;
+    }
+    if (joins_prev) {
+        p->free_ranges[i - 1].count += count;
+        return true;
+    }
+    if (joins_next) {
+        p->free_ranges[i].first = first;
+        p->free_ranges[i].count += count;
+        return true;
+    }
+
+    if (p->free_count == p->free_cap) {
+        size_t cap = p->free_cap ? p->free_cap * 2 : 32;
+        VertexRange* ranges = (VertexRange*)mem_realloc(MEM_TAG_GPU_MIRROR, p->free_ranges, cap * sizeof(VertexRange));
+        if (!ranges) return false;
+        p->free_ranges = ranges;
+        p->free_cap = cap;
+    }
+    memmove(&p->free_ranges[i + 1], &p->free_ranges[i], (p->free_count - i) * sizeof(VertexRange));
+    p->free_ranges[i].first = first;
+    p->free_ranges[i].count = count;
+    p->free_count++;
+    return true;
+}
+
+static bool chunk_pool_grow(ChunkPool* p, size_t min_vertices) {
+    size_t cap = p->vertex_capacity ? p->vertex_capacity : CHUNK_POOL_INITIAL_VERTICES;
+    while (cap < p->vertex_capacity + min_vertices) cap *= 2;
+
+    size_t vertex_bytes = MESH_VERTEX_FLOATS * sizeof(float);
+    GLuint vbo = 0;
+    glGenBuffers_(1, &vbo);
+    if (!vbo) return false;
+    gl_state_bind_buffer(GL_COPY_WRITE_BUFFER, vbo);
+    glBufferData_(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(cap * vertex_bytes), NULL, GL_DYNAMIC_DRAW);
+    if (p->vbo) {
+        gl_state_bind_buffer(GL_COPY_READ_BUFFER, (GLuint)p->vbo);
+        glCopyBufferSubData_(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)(p->vertex_capacity * vertex_bytes));
+        gl_state_delete_buffer((GLuint)p->vbo);
+    }
+
+    gl_state_bind_vertex_array((GLuint)p->vao);
+    gl_state_bind_buffer(GL_ARRAY_BUFFER, vbo);
+    bind_vertex_layout(0);
+    gl_state_bind_vertex_array(0);
+
+    size_t old_cap = p->vertex_capacity;
+    p->vbo = (uint32_t)vbo;
+    p->vertex_capacity = cap;
+    return free_range_insert(p, old_cap, cap - old_cap);
+}
+
+static bool chunk_pool_alloc(ChunkPool* p, size_t count, size_t* out_first) {
+    for (;;) {
+        for (size_t i = 0; i < p->free_count; i++) {
+            VertexRange* fr = &p->free_ranges[i];
+            if (fr->count < count) continue;
+            *out_first = fr->first;
+            fr->first += count;
+            fr->count -= count;
+            if (fr->count == 0) {
+                memmove(fr, fr + 1, (p->free_count - i - 1) * sizeof(VertexRange));
+                p->free_count--;
+            }
+            return true;
+        }
+        if (!chunk_pool_grow(p, count)) return false;
+    }
+}
+
+bool renderer_chunks_init(Renderer* r, int slot_count) {
+    ChunkPool* p = &r->chunks;
+    if (slot_count <= 0 || p->slots) return false;
+
+    size_t n = (size_t)slot_count;
+    p->slots = (VertexRange*)mem_calloc(MEM_TAG_GPU_MIRROR, n, sizeof(VertexRange));
+    p->slot_capacity = (size_t*)mem_calloc(MEM_TAG_GPU_MIRROR, n, sizeof(size_t));
+    p->origins = (Vec4*)mem_calloc(MEM_TAG_GPU_MIRROR, n, sizeof(Vec4));
+    p->mins = (Vec3*)mem_calloc(MEM_TAG_GPU_MIRROR, n, sizeof(Vec3));
+    p->maxs = (Vec3*)mem_calloc(MEM_TAG_GPU_MIRROR, n, sizeof(Vec3));
+    p->visible = (uint8_t*)mem_calloc(MEM_TAG_GPU_MIRROR, n, 1);
+    p->commands = (ChunkDrawCommand*)mem_calloc(MEM_TAG_GPU_MIRROR, n, sizeof(ChunkDrawCommand));
+    if (!p->slots || !p->slot_capacity || !p->origins || !p->mins || !p->maxs || !p->visible || !p->commands) return false;
+    p->slot_count = slot_count;
+
+    GLuint vao = 0, origin_vbo = 0;
+    glGenVertexArrays_(1, &vao);
+    glGenBuffers_(1, &origin_vbo);
+    if (!vao || !origin_vbo) return false;
+    p->vao = (uint32_t)vao;
+    p->origin_vbo = (uint32_t)origin_vbo;
+
+    gl_state_bind_vertex_array(vao);
+    gl_state_bind_buffer(GL_ARRAY_BUFFER, origin_vbo);
+    glBufferData_(GL_ARRAY_BUFFER, (GLsizeiptr)(n * sizeof(Vec4)), p->origins, GL_DYNAMIC_DRAW);
+    bind_origin_layout();
+    gl_state_bind_vertex_array(0);
+
+    return chunk_pool_grow(p, 0);
+}
+
+void renderer_chunk_clear(Renderer* r, int slot) {
+    ChunkPool* p = &r->chunks;
+    if (slot < 0 || slot >= p->slot_count) return;
+    free_range_insert(p, p->slots[slot].first, p->slot_capacity[slot]);
+    p->slots[slot].first = 0;
+    p->slots[slot].count = 0;
+    p->slot_capacity[slot] = 0;
+}
+
+size_t renderer_chunk_bytes(const Renderer* r, int slot) {
+    const ChunkPool* p = &r->chunks;
+    if (slot < 0 || slot >= p->slot_count) return 0;
+    return p->slot_capacity[slot] * MESH_VERTEX_FLOATS * sizeof(float);
+}
+
+bool renderer_chunk_upload(Renderer* r, int slot, const Mesh* mesh, Vec3 origin) {
+    ChunkPool* p = &r->chunks;
+    if (slot < 0 || slot >= p->slot_count) return false;
+
+    size_t count = mesh->vertex_count;
+    if (count > p->slot_capacity[slot] || count == 0) {
+        renderer_chunk_clear(r, slot);
+        if (count == 0) return true;
+        size_t cap = (count + CHUNK_POOL_GRANULARITY - 1) / CHUNK_POOL_GRANULARITY * CHUNK_POOL_GRANULARITY;
+        size_t first = 0;
+        if (!chunk_pool_alloc(p, cap, &first)) return false;
+        p->slots[slot].first = first;
+        p->slot_capacity[slot] = cap;
+    }
+    p->slots[slot].count = count;
+
+    size_t vertex_bytes = MESH_VERTEX_FLOATS * sizeof(float);
+    copy_to_buffer(r, (GLuint)p->vbo, p->slots[slot].first * vertex_bytes, mesh->vertices, count * vertex_bytes);
+
+    Vec3 lo = { mesh->vertices[0], mesh->vertices[1], mesh->vertices[2] };
+    Vec3 hi = lo;
+    for (size_t i = 1; i < count; i++) {
+        const float* v = &mesh->vertices[i * MESH_VERTEX_FLOATS];
+        lo.x = fminf(lo.x, v[0]);
+        lo.y = fminf(lo.y, v[1]);
+        lo.z = fminf(lo.z, v[2]);
+        hi.x = fmaxf(hi.x, v[0]);
+        hi.y = fmaxf(hi.y, v[1]);
+        hi.z = fmaxf(hi.z, v[2]);
+    }
+    p->mins[slot] = vec3_add(origin, lo);
+    p->maxs[slot] = vec3_add(origin, hi);
+
+    p->origins[slot] = (Vec4){ origin.x, origin.y, origin.z, 0.0f };
+    copy_to_buffer(r, (GLuint)p->origin_vbo, (size_t)slot * sizeof(Vec4), &p->origins[slot], sizeof(Vec4));
+    return true;
+}
+
+void renderer_chunks_set_view_distance(Renderer* r, Vec3 eye, float distance) {
+    r->chunks.view_eye = eye;
+    r->chunks.view_distance = distance;
+}
+
+static bool chunk_beyond_view(const ChunkPool* p, int i) {
+    if (p->view_distance <= 0.0f) return false;
+    const Vec3* e = &p->view_eye;
+    float dx = e->x < p->mins[i].x ? p->mins[i].x - e->x : (e->x > p->maxs[i].x ? e->x - p->maxs[i].x : 0.0f);
+    float dy = e->y < p->mins[i].y ? p->mins[i].y - e->y : (e->y > p->maxs[i].y ? e->y - p->maxs[i].y : 0.0f);
+    float dz = e->z < p->mins[i].z ? p->mins[i].z - e->z : (e->z > p->maxs[i].z ? e->z - p->maxs[i].z : 0.0f);
+    return dx * dx + dy * dy + dz * dz > p->view_distance * p->view_distance;
+}
+
+void renderer_draw_chunks(Renderer* r, Mat4 view_proj) {
+    ChunkPool* p = &r->chunks;
+    p->draw_count = 0;
+    if (!p->vao) return;
+
+    Vec4 planes[6];
+    mat4_frustum_planes(&view_proj, planes);
+    aabb_cull_planes(planes, p->mins, p->maxs, p->visible, (size_t)p->slot_count);
+
+    size_t n = 0;
+    for (int i = 0; i < p->slot_count; i++) {
+        if (!p->visible[i] || p->slots[i].count == 0) continue;
+        if (chunk_beyond_view(p, i)) continue;
+        ChunkDrawCommand* cmd = &p->commands[n++];
+        cmd->count = (uint32_t)p->slots[i].count;
+        cmd->instance_count = 1;
+        cmd->first = (uint32_t)p->slots[i].first;
+        cmd->base_instance = (uint32_t)i;
+    }
+    p->draw_count = n;
+    r->frame_stats.chunks_drawn += (uint32_t)n;
+    if (n == 0) return;
+
+    uint64_t triangles = 0;
+    for (size_t i = 0; i < n; i++) triangles += p->commands[i].count / 3;
+
+    gl_state_use_program(p->program);
+    gl_state_uniform_mat4(p->program, p->u_view_proj, view_proj.m);
+
+    gl_state_active_texture(GL_TEXTURE0);
+    gl_state_bind_texture_2d((GLuint)r->texture_atlas);
+
+    gl_state_bind_vertex_array((GLuint)p->vao);
+    size_t offset = 0;
+    r->frame_stats.triangles += triangles;
+    if (p->multi_draw && stream_upload(r, p->commands, n * sizeof(ChunkDrawCommand), &offset)) {
+        gl_state_bind_buffer(GL_DRAW_INDIRECT_BUFFER, (GLuint)r->stream.buffer);
+        glMultiDrawArraysIndirect_(GL_TRIANGLES, (void*)offset, (GLsizei)n, 0);
+        r->frame_stats.draw_calls++;
+        return;
+    }
+
+    glDisableVertexAttribArray_(4);
+    for (size_t i = 0; i < n; i++) {
+        const Vec4* o = &p->origins[p->commands[i].base_instance];
+        glVertexAttrib3f_(4, o->x, o->y, o->z);
+        glDrawArrays(GL_TRIANGLES, (GLint)p->commands[i].first, (GLsizei)p->commands[i].count);
+    }
+    glEnableVertexAttribArray_(4);
+    r->frame_stats.draw_calls += (uint32_t)n;
+}
+
+static void resolve_timer_queries(Renderer* r, int frame) {
+    for (int pass = 0; pass < RENDER_PASS_COUNT; pass++) {
+        if (!r->timer_pending[frame][pass]) continue;
+        r->timer_pending[frame][pass] = false;
+        GLint available = 0;
+        glGetQueryObjectiv_((GLuint)r->timer_queries[frame][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v_((GLuint)r->timer_queries[frame][pass], GL_QUERY_RESULT, &ns);
+        r->gpu_ms[pass] = (double)ns / 1000000.0;
+    }
+}
+
+void renderer_begin_pass(Renderer* r, RenderPass pass) {
+    if (!r->timers_enabled || r->active_pass >= 0) return;
+    glBeginQuery_(GL_TIME_ELAPSED, (GLuint)r->timer_queries[r->timer_frame][pass]);
+    r->active_pass = (int)pass;
+}
+
+void renderer_end_pass(Renderer* r) {
+    if (r->active_pass < 0) return;
+    glEndQuery_(GL_TIME_ELAPSED);
+    r->timer_pending[r->timer_frame][r->active_pass] = true;
+    r->active_pass = -1;
+}
+
+void renderer_end_frame(Renderer* r) {
+    renderer_end_pass(r);
+    stream_buffer_end_frame(&r->stream);
+
+    GlStateStats gs = gl_state_end_frame();
+    r->frame_stats.state_calls = gs.issued;
+    r->frame_stats.state_skipped = gs.skipped;
+
+    if (r->timers_enabled) {
+        r->timer_frame = (r->timer_frame + 1) % RENDER_TIMER_LATENCY;
+        resolve_timer_queries(r, r->timer_frame);
+    }
+    for (int pass = 0; pass < RENDER_PASS_COUNT; pass++) r->frame_stats.gpu_ms[pass] = r->gpu_ms[pass];
+
+    r->last_stats = r->frame_stats;
+    memset(&r->frame_stats, 0, sizeof(r->frame_stats));
+}
+
+const RenderStats* renderer_stats(const Renderer* r) {
+    return &r->last_stats;
+}
+
+const char* renderer_pass_name(RenderPass pass) {
+    switch (pass) {
+        case RENDER_PASS_WORLD: return "world";
+        case RENDER_PASS_VIEWMODEL: return "viewmodel";
+        default: return "?";
+    }
 }
@@ -0,0 +1,179 @@
+#include "replay.h"
+
+#include "mem_track.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_MAGIC 0x594C5052u
+#define REPLAY_VERSION 2u
+
+#define REPLAY_FLAG_QUIT 0x01u
+#define REPLAY_FLAG_FOCUS 0x02u
+
+typedef struct ReplayHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t seed;
+    uint32_t generator;
+    uint32_t tick_hz;
+    uint32_t frame_count;
+    uint32_t pad;
+} ReplayHeader;
+
+typedef struct ReplayFrame {
+    double dt;
+    int32_t mouse_dx;
+    int32_t mouse_dy;
+    uint16_t width;
+    uint16_t height;
+    uint8_t flags;
+    uint8_t pad;
+    uint16_t key_toggles;
+} ReplayFrame;
+
+static uint64_t hash_bytes(uint64_t h, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool replay_writer_open(ReplayWriter* w, const char* path, uint64_t seed, uint32_t generator, int tick_hz) {
+    memset(w, 0, sizeof(*w));
+    w->file = fopen(path, "wb");
+    if (!w->file) return false;
+
+    ReplayHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = REPLAY_MAGIC;
+    hdr.version = REPLAY_VERSION;
+    hdr.seed = seed;
+    hdr.generator = generator;
+    hdr.tick_hz = (uint32_t)tick_hz;
+    if (fwrite(&hdr, sizeof(hdr), 1, w->file) != 1) {
+        fclose(w->file);
+        w->file = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool replay_writer_frame(ReplayWriter* w, const AppInput* in, double dt) {
+    if (!w->file) return false;
+
+    uint8_t toggles[256];
+    uint16_t n = 0;
+    for (int k = 0; k < 256; k++) {
+        if (in->keys[k] != w->prev.keys[k]) toggles[n++] = (uint8_t)k;
+    }
+
+    ReplayFrame f;
+    memset(&f, 0, sizeof(f));
+    f.dt = dt;
+    f.mouse_dx = in->mouse_dx;
+    f.mouse_dy = in->mouse_dy;
+    f.width = (uint16_t)in->width;
+    f.height = (uint16_t)in->height;
+    f.flags = (uint8_t)((in->quit_requested ? REPLAY_FLAG_QUIT : 0u) | (in->has_focus ? REPLAY_FLAG_FOCUS : 0u));
+    f.key_toggles = n;
+
+    bool ok = fwrite(&f, sizeof(f), 1, w->file) == 1;
+    if (ok && n) ok = fwrite(toggles, 1, n, w->file) == n;
+    if (!ok) return false;
+
+    w->prev = *in;
+    w->frame_count++;
+    return true;
+}
+
+bool replay_writer_close(ReplayWriter* w) {
+    if (!w->file) return false;
+    bool ok = fseek(w->file, (long)offsetof(ReplayHeader, frame_count), SEEK_SET) == 0;
+    ok = ok && fwrite(&w->frame_count, sizeof(w->frame_count), 1, w->file) == 1;
+    ok = (fclose(w->file) == 0) && ok;
+    memset(w, 0, sizeof(*w));
+    return ok;
+}
+
+bool replay_reader_open(ReplayReader* r, const char* path) {
+    memset(r, 0, sizeof(*r));
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+
+    bool ok = fseek(f, 0, SEEK_END) == 0;
+    long size = ok ? ftell(f) : -1;
+    ok = ok && size >= (long)sizeof(ReplayHeader) && fseek(f, 0, SEEK_SET) == 0;
+    if (ok) {
+        r->data = (uint8_t*)mem_alloc(MEM_TAG_SCRATCH, (size_t)size);
+        ok = r->data && fread(r->data, 1, (size_t)size, f) == (size_t)size;
+    }
+    fclose(f);
+
+    ReplayHeader hdr;
+    if (ok) {
+        memcpy(&hdr, r->data, sizeof(hdr));
+        ok = hdr.magic == REPLAY_MAGIC && hdr.version == REPLAY_VERSION;
+    }
+    if (!ok) {
+        replay_reader_close(r);
+        return false;
+    }
+
+    r->size = (size_t)size;
+    r->pos = sizeof(hdr);
+    r->seed = hdr.seed;
+    r->generator = hdr.generator;
+    r->tick_hz = (int)hdr.tick_hz;
+    r->frame_count = hdr.frame_count;
+    return true;
+}
+
+bool replay_reader_next(ReplayReader* r, AppInput* out_input, double* out_dt) {
+    if (r->frame >= r->frame_count || r->pos + sizeof(ReplayFrame) > r->size) return false;
+
+    ReplayFrame f;
+    memcpy(&f, r->data + r->pos, sizeof(f));
+    r->pos += sizeof(f);
+    if (r->pos + f.key_toggles > r->size) return false;
+    for (uint16_t i = 0; i < f.key_toggles; i++) {
+        uint8_t k = r->data[r->pos + i];
+        r->input.keys[k] = !r->input.keys[k];
+    }
+    r->pos += f.key_toggles;
+
+    r->input.mouse_dx = f.mouse_dx;
+    r->input.mouse_dy = f.mouse_dy;
+    r->input.width = f.width;
+    r->input.height = f.height;
+    r->input.quit_requested = (f.flags & REPLAY_FLAG_QUIT) != 0;
+    r->input.has_focus = (f.flags & REPLAY_FLAG_FOCUS) != 0;
+    r->frame++;
+
+    *out_input = r->input;
+    *out_dt = f.dt;
+    return true;
+}
+
+void replay_reader_close(ReplayReader* r) {
+    if (!r) return;
+    mem_free(MEM_TAG_SCRATCH, r->data);
+    memset(r, 0, sizeof(*r));
+}
+
+uint64_t replay_state_hash(const World* world, const Camera* cam) {
+    uint64_t h = 14695981039346656037ull;
+    int n = world_chunk_count(world);
+    for (int i = 0; i < n; i++) h = hash_bytes(h, world_chunk_at(world, i)->blocks, CHUNK_VOLUME);
+    h = hash_bytes(h, &cam->position_feet, sizeof(cam->position_feet));
+    h = hash_bytes(h, &cam->velocity, sizeof(cam->velocity));
+    h = hash_bytes(h, &cam->yaw, sizeof(cam->yaw));
+    h = hash_bytes(h, &cam->pitch, sizeof(cam->pitch));
+    h = hash_bytes(h, &cam->on_ground, sizeof(cam->on_ground));
+    return h;
+}
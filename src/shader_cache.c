@@ -0,0 +1,193 @@
+#include "shader_cache.h"
+
+#include "gl_loader.h"
+#include "mem_track.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define make_dir(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define make_dir(path) mkdir(path, 0755)
+#endif
+
+#define SHADER_CACHE_MAGIC 0x43425053u
+#define SHADER_CACHE_VERSION 1u
+
+typedef struct ShaderCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+} ShaderCacheHeader;
+
+static uint64_t fnv1a(uint64_t h, const char* s) {
+    if (!s) s = "";
+    for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+        h ^= (uint64_t)*p;
+        h *= 1099511628211ull;
+    }
+    h ^= 0xFFu;
+    h *= 1099511628211ull;
+    return h;
+}
+
+static uint64_t program_key(const char* vs_src, const char* fs_src) {
+    uint64_t h = 14695981039346656037ull;
+    h = fnv1a(h, vs_src);
+    h = fnv1a(h, fs_src);
+    h = fnv1a(h, (const char*)glGetString(GL_VENDOR));
+    h = fnv1a(h, (const char*)glGetString(GL_RENDERER));
+    h = fnv1a(h, (const char*)glGetString(GL_VERSION));
+    return h;
+}
+
+static void cache_path(char* out, size_t out_size, const char* name) {
+    snprintf(out, out_size, "%s/%s.bin", SHADER_CACHE_DIR, name);
+}
+
+static uint32_t compile_shader(uint32_t type, const char* src) {
+    GLuint s = glCreateShader_(type);
+    const GLchar* strings[] = { (const GLchar*)src };
+    glShaderSource_(s, 1, strings, NULL);
+    glCompileShader_(s);
+    GLint ok = 0;
+    glGetShaderiv_(s, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        glDeleteShader_(s);
+        return 0;
+    }
+    return (uint32_t)s;
+}
+
+static uint32_t link_program(uint32_t vs, uint32_t fs, bool retrievable) {
+    GLuint p = glCreateProgram_();
+    if (retrievable) glProgramParameteri_(p, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader_(p, vs);
+    glAttachShader_(p, fs);
+    glLinkProgram_(p);
+    GLint ok = 0;
+    glGetProgramiv_(p, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        glDeleteProgram_(p);
+        return 0;
+    }
+    return (uint32_t)p;
+}
+
+static uint32_t build_from_source(const char* vs_src, const char* fs_src, bool retrievable) {
+    uint32_t vs = compile_shader(GL_VERTEX_SHADER, vs_src);
+    uint32_t fs = compile_shader(GL_FRAGMENT_SHADER, fs_src);
+    if (!vs || !fs) {
+        if (vs) glDeleteShader_(vs);
+        if (fs) glDeleteShader_(fs);
+        return 0;
+    }
+
+    uint32_t prog = link_program(vs, fs, retrievable);
+    glDeleteShader_(vs);
+    glDeleteShader_(fs);
+    return prog;
+}
+
+static uint32_t load_cached(const char* path, uint64_t key) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+
+    ShaderCacheHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+        hdr.magic != SHADER_CACHE_MAGIC || hdr.version != SHADER_CACHE_VERSION ||
+        hdr.key != key || hdr.length == 0) {
+        fclose(f);
+        return 0;
+    }
+
+    void* blob = mem_alloc(MEM_TAG_SCRATCH, hdr.length);
+    if (!blob) {
+        fclose(f);
+        return 0;
+    }
+    bool read_ok = fread(blob, 1, hdr.length, f) == hdr.length;
+    fclose(f);
+    if (!read_ok) {
+        mem_free(MEM_TAG_SCRATCH, blob);
+        return 0;
+    }
+
+    GLuint p = glCreateProgram_();
+    glProgramBinary_(p, (GLenum)hdr.format, blob, (GLsizei)hdr.length);
+    mem_free(MEM_TAG_SCRATCH, blob);
+
+    GLint ok = 0;
+    glGetProgramiv_(p, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        glDeleteProgram_(p);
+        return 0;
+    }
+    return (uint32_t)p;
+}
+
+static bool store_cached(const char* path, uint64_t key, uint32_t program) {
+    GLint length = 0;
+    glGetProgramiv_(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return false;
+
+    void* blob = mem_alloc(MEM_TAG_SCRATCH, (size_t)length);
+    if (!blob) return false;
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary_(program, length, &written, &format, blob);
+    if (written <= 0) {
+        mem_free(MEM_TAG_SCRATCH, blob);
+        return false;
+    }
+
+    make_dir(SHADER_CACHE_DIR);
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        mem_free(MEM_TAG_SCRATCH, blob);
+        return false;
+    }
+
+    ShaderCacheHeader hdr = { SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, key, (uint32_t)format, (uint32_t)written };
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 && fwrite(blob, 1, (size_t)written, f) == (size_t)written;
+    fclose(f);
+    mem_free(MEM_TAG_SCRATCH, blob);
+    if (!ok) remove(path);
+    return ok;
+}
+
+uint32_t shader_cache_build_program(const char* name, const char* vs_src, const char* fs_src, ShaderCacheStats* io_stats) {
+    bool use_cache = name && gl_has_program_binary();
+    char path[512];
+    uint64_t key = 0;
+
+    if (use_cache) {
+        cache_path(path, sizeof(path), name);
+        key = program_key(vs_src, fs_src);
+        uint32_t prog = load_cached(path, key);
+        if (prog) {
+            if (io_stats) {
+                io_stats->programs_built++;
+                io_stats->cache_hits++;
+            }
+            return prog;
+        }
+    }
+
+    uint32_t prog = build_from_source(vs_src, fs_src, use_cache);
+    if (!prog) return 0;
+    if (io_stats) io_stats->programs_built++;
+
+    if (use_cache && store_cached(path, key, prog) && io_stats) {
+        io_stats->cache_writes++;
+    }
+    return prog;
+}
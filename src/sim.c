@@ -0,0 +1,294 @@
+#include "sim.h"
+
+#include "block_tick.h"
+#include "math4.h"
+#include "thread.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+static bool aabb_hits_world(const World* world, float minx, float miny, float minz, float maxx, float maxy, float maxz) {
+    int x0 = (int)floorf(minx);
+    int y0 = (int)floorf(miny);
+    int z0 = (int)floorf(minz);
+    int x1 = (int)floorf(maxx);
+    int y1 = (int)floorf(maxy);
+    int z1 = (int)floorf(maxz);
+
+    for (int z = z0; z <= z1; z++) {
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                BlockType t = world_get(world, x, y, z);
+                if (world_is_solid(t)) return true;
+            }
+        }
+    }
+    return false;
+}
+
+void sim_step_player(const World* world, Camera* cam, const AppInput* in, float dt) {
+    const float player_radius = 0.3f;
+    const float player_height = 1.8f;
+
+    const float mouse_sensitivity = 0.0022f;
+    camera_apply_mouse(cam, in->mouse_dx, in->mouse_dy, mouse_sensitivity);
+
+    float speed = in->keys[APP_KEY_SHIFT] ? 8.0f : 5.0f;
+    Vec3 f = camera_forward_xz(cam);
+    Vec3 r = camera_right_xz(cam);
+    Vec3 move = (Vec3){ 0 };
+
+    if (in->keys['W']) move = vec3_add(move, f);
+    if (in->keys['S']) move = vec3_sub(move, f);
+    if (in->keys['D']) move = vec3_add(move, r);
+    if (in->keys['A']) move = vec3_sub(move, r);
+
+    if (vec3_len(move) > 0.001f) move = vec3_norm(move);
+
+    cam->velocity.x = move.x * speed;
+    cam->velocity.z = move.z * speed;
+
+    if (cam->on_ground && in->keys[APP_KEY_SPACE]) {
+        cam->velocity.y = 7.0f;
+        cam->on_ground = false;
+    }
+
+    cam->velocity.y += -20.0f * dt;
+    if (cam->velocity.y < -60.0f) cam->velocity.y = -60.0f;
+
+    Vec3 p = cam->position_feet;
+
+    p.x += cam->velocity.x * dt;
+    {
+        float minx = p.x - player_radius;
+        float maxx = p.x + player_radius;
+        float miny = p.y;
+        float maxy = p.y + player_height;
+        float minz = p.z - player_radius;
+        float maxz = p.z + player_radius;
+        if (aabb_hits_world(world, minx, miny, minz, maxx, maxy, maxz)) {
+            p.x -= cam->velocity.x * dt;
+            cam->velocity.x = 0.0f;
+        }
+    }
+
+    p.z += cam->velocity.z * dt;
+    {
+        float minx = p.x - player_radius;
+        float maxx = p.x + player_radius;
+        float miny = p.y;
+        float maxy = p.y + player_height;
+        float minz = p.z - player_radius;
+        float maxz = p.z + player_radius;
+        if (aabb_hits_world(world, minx, miny, minz, maxx, maxy, maxz)) {
+            p.z -= cam->velocity.z * dt;
+            cam->velocity.z = 0.0f;
+        }
+    }
+
+    float dy = cam->velocity.y * dt;
+    p.y += dy;
+    cam->on_ground = false;
+    {
+        float minx = p.x - player_radius;
+        float maxx = p.x + player_radius;
+        float miny = p.y;
+        float maxy = p.y + player_height;
+        float minz = p.z - player_radius;
+        float maxz = p.z + player_radius;
+
+        if (aabb_hits_world(world, minx, miny, minz, maxx, maxy, maxz)) {
+            p.y -= dy;
+            if (dy < 0.0f) cam->on_ground = true;
+            cam->velocity.y = 0.0f;
+        }
+    }
+
+    if (p.y < 1.0f) {
+        p.y = 1.0f;
+        cam->velocity.y = 0.0f;
+        cam->on_ground = true;
+    }
+
+    cam->position_feet = p;
+}
+
+static void take_tick_input(Sim* sim, AppInput* out) {
+    memset(out, 0, sizeof(*out));
+    memcpy(out->keys, sim->keys, sizeof(out->keys));
+    out->mouse_dx = sim->pending_mouse_dx;
+    out->mouse_dy = sim->pending_mouse_dy;
+    sim->pending_mouse_dx = 0;
+    sim->pending_mouse_dy = 0;
+}
+
+static void sim_thread_main(void* user) {
+    Sim* sim = (Sim*)user;
+    double next = sim->clock() + sim->tick_dt;
+
+    for (;;) {
+        double now = sim->clock();
+        int ticks = 0;
+        while (now >= next && ticks < SIM_MAX_TICKS_PER_UPDATE) {
+            AppInput in;
+            Camera cam;
+
+            mutex_lock(sim->lock);
+            bool running = sim->running;
+            take_tick_input(sim, &in);
+            cam = sim->curr;
+            mutex_unlock(sim->lock);
+            if (!running) return;
+
+            if (sim->world_lock) mutex_lock(sim->world_lock);
+            sim_step_player(sim->world, &cam, &in, (float)sim->tick_dt);
+            if (sim->world_lock) mutex_unlock(sim->world_lock);
+
+            mutex_lock(sim->lock);
+            sim->prev = sim->curr;
+            sim->curr = cam;
+            sim->curr_time = next;
+            sim->tick++;
+            mutex_unlock(sim->lock);
+
+            next += sim->tick_dt;
+            ticks++;
+        }
+        if (now - next > sim->tick_dt * SIM_MAX_TICKS_PER_UPDATE) {
+            next = now + sim->tick_dt;
+        }
+
+        mutex_lock(sim->lock);
+        bool running = sim->running;
+        mutex_unlock(sim->lock);
+        if (!running) return;
+
+        double wait = next - sim->clock();
+        thread_sleep_ms(wait > 0.002 ? (int)(wait * 1000.0) - 1 : 0);
+    }
+}
+
+bool sim_init(Sim* sim, SimDesc desc) {
+    memset(sim, 0, sizeof(*sim));
+    if (!desc.world) return false;
+    if (desc.threaded && !desc.clock) return false;
+
+    int hz = desc.tick_hz > 0 ? desc.tick_hz : SIM_DEFAULT_TICK_HZ;
+    sim->world = desc.world;
+    sim->tick_dt = 1.0 / (double)hz;
+    sim->prev = desc.camera;
+    sim->curr = desc.camera;
+    sim->clock = desc.clock;
+    sim->ticks = desc.ticks;
+
+    if (!desc.threaded) return true;
+
+    if (!mutex_create(&sim->lock)) return false;
+    if (sim->ticks && !mutex_create(&sim->world_lock)) {
+        mutex_destroy(sim->lock);
+        sim->lock = NULL;
+        return false;
+    }
+    sim->threaded = true;
+    sim->running = true;
+    sim->curr_time = sim->clock();
+    if (!thread_create(&sim->thread, sim_thread_main, sim)) {
+        mutex_destroy(sim->lock);
+        sim->lock = NULL;
+        if (sim->world_lock) mutex_destroy(sim->world_lock);
+        sim->world_lock = NULL;
+        sim->threaded = false;
+        sim->running = false;
+        return false;
+    }
+    return true;
+}
+
+void sim_shutdown(Sim* sim) {
+    if (!sim) return;
+    if (sim->thread) {
+        mutex_lock(sim->lock);
+        sim->running = false;
+        mutex_unlock(sim->lock);
+        thread_join(sim->thread);
+        sim->thread = NULL;
+    }
+    if (sim->lock) {
+        mutex_destroy(sim->lock);
+        sim->lock = NULL;
+    }
+    if (sim->world_lock) {
+        mutex_destroy(sim->world_lock);
+        sim->world_lock = NULL;
+    }
+    sim->threaded = false;
+}
+
+void sim_submit_input(Sim* sim, const AppInput* in) {
+    if (sim->threaded) mutex_lock(sim->lock);
+    memcpy(sim->keys, in->keys, sizeof(sim->keys));
+    sim->pending_mouse_dx += in->mouse_dx;
+    sim->pending_mouse_dy += in->mouse_dy;
+    if (sim->threaded) mutex_unlock(sim->lock);
+}
+
+static void catch_up_block_ticks(Sim* sim) {
+    mutex_lock(sim->lock);
+    uint64_t target = sim->tick;
+    mutex_unlock(sim->lock);
+
+    for (int i = 0; i < SIM_MAX_TICKS_PER_UPDATE && sim->ticks->tick < target; i++) {
+        block_tick_evaluate(sim->ticks, sim->ticks->tick + 1);
+        mutex_lock(sim->world_lock);
+        block_tick_apply(sim->ticks);
+        mutex_unlock(sim->world_lock);
+    }
+}
+
+int sim_update(Sim* sim, double frame_dt) {
+    if (sim->threaded) {
+        if (sim->ticks) catch_up_block_ticks(sim);
+        return 0;
+    }
+
+    sim->accumulator += frame_dt;
+    double max_backlog = sim->tick_dt * SIM_MAX_TICKS_PER_UPDATE;
+    if (sim->accumulator > max_backlog) sim->accumulator = max_backlog;
+
+    int ticks = 0;
+    while (sim->accumulator >= sim->tick_dt) {
+        AppInput in;
+        take_tick_input(sim, &in);
+        sim->prev = sim->curr;
+        sim_step_player(sim->world, &sim->curr, &in, (float)sim->tick_dt);
+        sim->accumulator -= sim->tick_dt;
+        sim->tick++;
+        if (sim->ticks) block_tick_step(sim->ticks, sim->tick);
+        ticks++;
+    }
+    return ticks;
+}
+
+Camera sim_camera(Sim* sim, float* out_alpha) {
+    Camera a, b;
+    double alpha;
+
+    if (sim->threaded) {
+        mutex_lock(sim->lock);
+        a = sim->prev;
+        b = sim->curr;
+        alpha = (sim->clock() - sim->curr_time) / sim->tick_dt;
+        mutex_unlock(sim->lock);
+    } else {
+        a = sim->prev;
+        b = sim->curr;
+        alpha = sim->accumulator / sim->tick_dt;
+    }
+
+    if (alpha < 0.0) alpha = 0.0;
+    if (alpha > 1.0) alpha = 1.0;
+    if (out_alpha) *out_alpha = (float)alpha;
+    return camera_lerp(&a, &b, (float)alpha);
+}
@@ -0,0 +1,211 @@
+#include "snapshot.h"
+
+#include "block.h"
+#include "mem_track.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SNAPSHOT_MAGIC 0x4E535856u
+#define SNAPSHOT_VERSION 2u
+#define SNAPSHOT_ALIGN 64u
+
+typedef struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t file_size;
+    int32_t w;
+    int32_t h;
+    int32_t d;
+    int32_t chunks_x;
+    int32_t chunks_y;
+    int32_t chunks_z;
+    uint32_t chunk_stride;
+    uint32_t vertex_floats;
+    uint64_t chunk_offset;
+    uint64_t chunk_count;
+    uint64_t mesh_table_offset;
+    uint64_t mesh_offset;
+    uint64_t mesh_vertex_count;
+} SnapshotHeader;
+
+typedef struct SnapshotMeshEntry {
+    uint64_t first;
+    uint64_t vertex_count;
+} SnapshotMeshEntry;
+
+static uint64_t align_up(uint64_t v, uint64_t a) {
+    return (v + a - 1) & ~(a - 1);
+}
+
+static uint64_t hash_bytes(uint64_t h, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t snapshot_key(int w, int h, int d, uint64_t seed, uint32_t generator) {
+    block_registry_init();
+    uint32_t layout[5] = { SNAPSHOT_VERSION, (uint32_t)sizeof(Chunk), MESH_VERTEX_FLOATS, CHUNK_SIZE, 0 };
+    int32_t dims[3] = { w, h, d };
+    uint64_t k = 14695981039346656037ull;
+    k = hash_bytes(k, layout, sizeof(layout));
+    k = hash_bytes(k, dims, sizeof(dims));
+    k = hash_bytes(k, &seed, sizeof(seed));
+    k = hash_bytes(k, &generator, sizeof(generator));
+    uint64_t reg = block_registry_hash();
+    k = hash_bytes(k, &reg, sizeof(reg));
+    return k;
+}
+
+bool snapshot_load(Snapshot* snap, const char* path, uint64_t key, World* out_world, Mesh** out_meshes) {
+    memset(snap, 0, sizeof(*snap));
+    if (!mapped_file_open(&snap->file, path)) return false;
+
+    const uint8_t* base = (const uint8_t*)snap->file.data;
+    SnapshotHeader hdr;
+    if (snap->file.size < sizeof(hdr)) goto fail;
+    memcpy(&hdr, base, sizeof(hdr));
+
+    if (hdr.magic != SNAPSHOT_MAGIC || hdr.version != SNAPSHOT_VERSION || hdr.key != key) goto fail;
+    if (hdr.file_size != snap->file.size) goto fail;
+    if (hdr.chunk_stride != sizeof(Chunk) || hdr.vertex_floats != MESH_VERTEX_FLOATS) goto fail;
+    if ((uint64_t)hdr.chunks_x * (uint64_t)hdr.chunks_y * (uint64_t)hdr.chunks_z != hdr.chunk_count) goto fail;
+    if (hdr.chunk_offset + hdr.chunk_count * hdr.chunk_stride > hdr.file_size) goto fail;
+    if (hdr.mesh_table_offset + hdr.chunk_count * sizeof(SnapshotMeshEntry) > hdr.file_size) goto fail;
+    if (hdr.mesh_offset + hdr.mesh_vertex_count * MESH_VERTEX_FLOATS * sizeof(float) > hdr.file_size) goto fail;
+
+    block_registry_init();
+
+    Mesh* meshes = (Mesh*)mem_calloc(MEM_TAG_MESH, (size_t)hdr.chunk_count, sizeof(Mesh));
+    if (!meshes) goto fail;
+    float* vertices = (float*)((uint8_t*)snap->file.data + hdr.mesh_offset);
+    for (uint64_t i = 0; i < hdr.chunk_count; i++) {
+        SnapshotMeshEntry e;
+        memcpy(&e, base + hdr.mesh_table_offset + i * sizeof(e), sizeof(e));
+        if (e.first + e.vertex_count > hdr.mesh_vertex_count) {
+            mem_free(MEM_TAG_MESH, meshes);
+            goto fail;
+        }
+        meshes[i].vertices = vertices + e.first * MESH_VERTEX_FLOATS;
+        meshes[i].vertex_count = (size_t)e.vertex_count;
+        meshes[i].external = true;
+    }
+
+    memset(out_world, 0, sizeof(*out_world));
+    out_world->w = hdr.w;
+    out_world->h = hdr.h;
+    out_world->d = hdr.d;
+    out_world->chunks_x = hdr.chunks_x;
+    out_world->chunks_y = hdr.chunks_y;
+    out_world->chunks_z = hdr.chunks_z;
+    out_world->chunks_external = true;
+    out_world->light_ready = true;
+    out_world->chunks = (Chunk**)mem_alloc(MEM_TAG_WORLD, (size_t)hdr.chunk_count * sizeof(Chunk*));
+    if (!out_world->chunks || !world_alloc_heightmaps(out_world)) {
+        mem_free(MEM_TAG_MESH, meshes);
+        mem_free(MEM_TAG_WORLD, out_world->chunks);
+        memset(out_world, 0, sizeof(*out_world));
+        goto fail;
+    }
+    Chunk* mapped = (Chunk*)((uint8_t*)snap->file.data + hdr.chunk_offset);
+    for (uint64_t i = 0; i < hdr.chunk_count; i++) out_world->chunks[i] = &mapped[i];
+    world_build_heightmaps(out_world);
+
+    *out_meshes = meshes;
+    return true;
+
+fail:
+    mapped_file_close(&snap->file);
+    return false;
+}
+
+static bool write_padding(FILE* f, uint64_t* io_pos, uint64_t target) {
+    static const uint8_t zeros[SNAPSHOT_ALIGN] = { 0 };
+    while (*io_pos < target) {
+        size_t n = (size_t)(target - *io_pos);
+        if (n > sizeof(zeros)) n = sizeof(zeros);
+        if (fwrite(zeros, 1, n, f) != n) return false;
+        *io_pos += n;
+    }
+    return true;
+}
+
+bool snapshot_save(const char* path, uint64_t key, const World* world, const Mesh* meshes) {
+    if (!world || !world->chunks || !meshes) return false;
+
+    SnapshotHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = SNAPSHOT_MAGIC;
+    hdr.version = SNAPSHOT_VERSION;
+    hdr.key = key;
+    hdr.w = world->w;
+    hdr.h = world->h;
+    hdr.d = world->d;
+    hdr.chunks_x = world->chunks_x;
+    hdr.chunks_y = world->chunks_y;
+    hdr.chunks_z = world->chunks_z;
+    hdr.chunk_stride = (uint32_t)sizeof(Chunk);
+    hdr.vertex_floats = MESH_VERTEX_FLOATS;
+    hdr.chunk_count = (uint64_t)world->chunks_x * (uint64_t)world->chunks_y * (uint64_t)world->chunks_z;
+    hdr.chunk_offset = align_up(sizeof(hdr), SNAPSHOT_ALIGN);
+    hdr.mesh_table_offset = align_up(hdr.chunk_offset + hdr.chunk_count * hdr.chunk_stride, SNAPSHOT_ALIGN);
+    hdr.mesh_offset = align_up(hdr.mesh_table_offset + hdr.chunk_count * sizeof(SnapshotMeshEntry), SNAPSHOT_ALIGN);
+    for (uint64_t i = 0; i < hdr.chunk_count; i++) hdr.mesh_vertex_count += meshes[i].vertex_count;
+    hdr.file_size = hdr.mesh_offset + hdr.mesh_vertex_count * MESH_VERTEX_FLOATS * sizeof(float);
+
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE* f = fopen(tmp_path, "wb");
+    if (!f) return false;
+
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+    uint64_t pos = sizeof(hdr);
+    ok = ok && write_padding(f, &pos, hdr.chunk_offset);
+
+    for (uint64_t i = 0; ok && i < hdr.chunk_count; i++) {
+        Chunk c = *world_chunk_at(world, (int)i);
+        c.dirty = false;
+        ok = fwrite(&c, sizeof(c), 1, f) == 1;
+        pos += sizeof(c);
+    }
+
+    ok = ok && write_padding(f, &pos, hdr.mesh_table_offset);
+    uint64_t first = 0;
+    for (uint64_t i = 0; ok && i < hdr.chunk_count; i++) {
+        SnapshotMeshEntry e = { first, meshes[i].vertex_count };
+        ok = fwrite(&e, sizeof(e), 1, f) == 1;
+        pos += sizeof(e);
+        first += e.vertex_count;
+    }
+
+    ok = ok && write_padding(f, &pos, hdr.mesh_offset);
+    for (uint64_t i = 0; ok && i < hdr.chunk_count; i++) {
+        size_t n = meshes[i].vertex_count * MESH_VERTEX_FLOATS;
+        if (n) ok = fwrite(meshes[i].vertices, sizeof(float), n, f) == n;
+    }
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok) {
+        remove(tmp_path);
+        return false;
+    }
+    remove(path);
+    if (rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+void snapshot_close(Snapshot* snap) {
+    if (!snap) return;
+    mapped_file_close(&snap->file);
+}
@@ -0,0 +1,158 @@
+#include "block.h"
+#include "block_tick.h"
+#include "camera.h"
+#include "chunk_slab.h"
+#include "math4.h"
+#include "mem_track.h"
+#include "mesh.h"
+#include "renderer.h"
+#include "replay.h"
+#include "sim.h"
+#include "soft_renderer.h"
+#include "world.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    const char* out_path = "frame.ppm";
+    int width = SOFT_DEFAULT_WIDTH;
+    int height = SOFT_DEFAULT_HEIGHT;
+    int frames = 1;
+    int threads = 0;
+    const char* replay_path = NULL;
+    bool mem_stats = false;
+    bool block_ticks = true;
+    WorldGenerator generator = WORLD_GEN_TERRAIN;
+    uint64_t seed = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) sscanf(argv[++i], "%dx%d", &width, &height);
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replay_path = argv[++i];
+        else if (strcmp(argv[i], "--mem-stats") == 0) mem_stats = true;
+        else if (strcmp(argv[i], "--flat") == 0) generator = WORLD_GEN_FLAT;
+        else if (strcmp(argv[i], "--no-block-ticks") == 0) block_ticks = false;
+    }
+    if (frames < 1) frames = 1;
+
+    ReplayReader replay = { 0 };
+    if (replay_path && !replay_reader_open(&replay, replay_path)) {
+        fprintf(stderr, "headless: cannot read replay %s\n", replay_path);
+        return 1;
+    }
+    if (replay.data) {
+        generator = (WorldGenerator)replay.generator;
+        seed = replay.seed;
+    }
+
+    Renderer renderer;
+    if (!renderer_init(&renderer)) {
+        fprintf(stderr, "headless: renderer init failed\n");
+        replay_reader_close(&replay);
+        return 1;
+    }
+    if (threads > 0) soft_renderer_set_threads(threads);
+    renderer_resize(width, height);
+
+    World world;
+    if (!world_init(&world, 64, 24, 64)) {
+        renderer_shutdown(&renderer);
+        replay_reader_close(&replay);
+        return 1;
+    }
+    world_generate(&world, generator, seed);
+    Mesh mesh = world_build_mesh(&world);
+
+    Camera cam;
+    camera_init(&cam);
+    cam.position_feet = (Vec3){ 32.0f, 26.0f, 76.0f };
+    cam.pitch = -0.45f;
+    Mat4 vp = camera_view_proj(&cam, width, height);
+
+    Sim sim;
+    BlockTicker ticks = { 0 };
+    if (replay.data) {
+        camera_init(&cam);
+        cam.position_feet = world_spawn_point(&world);
+        BlockTickDesc tick_desc = { seed, BLOCK_TICK_RANDOM_PER_CHUNK, BLOCK_TICK_DEFAULT_BUDGET, threads };
+        if (block_ticks && !block_tick_init(&ticks, &world, tick_desc)) {
+            fprintf(stderr, "headless: block ticks disabled, out of memory\n");
+        }
+        SimDesc sim_desc = { &world, cam, replay.tick_hz, false, now_seconds, ticks.world ? &ticks : NULL };
+        if (!sim_init(&sim, sim_desc)) {
+            block_tick_shutdown(&ticks);
+            mesh_free(&mesh);
+            world_shutdown(&world);
+            renderer_shutdown(&renderer);
+            replay_reader_close(&replay);
+            return 1;
+        }
+        frames = 0;
+    }
+
+    double t0 = now_seconds();
+    if (replay.data) {
+        AppInput input;
+        double dt;
+        while (replay_reader_next(&replay, &input, &dt)) {
+            sim_submit_input(&sim, &input);
+            sim_update(&sim, dt);
+            Camera view_cam = sim_camera(&sim, NULL);
+            soft_renderer_clear(block_rgba(0x85, 0xBF, 0xF2, 0xFF));
+            renderer_draw_mesh(&renderer, &mesh, camera_view_proj(&view_cam, width, height));
+            frames++;
+        }
+    } else {
+        for (int f = 0; f < frames; f++) {
+            soft_renderer_clear(block_rgba(0x85, 0xBF, 0xF2, 0xFF));
+            renderer_draw_mesh(&renderer, &mesh, vp);
+        }
+    }
+    double elapsed = now_seconds() - t0;
+    if (frames < 1) frames = 1;
+    SoftStats stats = soft_renderer_take_stats();
+
+    fprintf(stderr, "headless: %dx%d, %d frame(s), %.2f ms/frame, %llu/%llu tris binned, %llu tile refs, %llu px written\n",
+        width, height, frames, elapsed * 1000.0 / (double)frames,
+        (unsigned long long)stats.triangles_binned, (unsigned long long)stats.triangles_in,
+        (unsigned long long)stats.tile_refs, (unsigned long long)stats.pixels_written);
+
+    if (replay.data) {
+        fprintf(stderr, "headless: replay %u/%u frames, %llu ticks, camera (%.3f, %.3f, %.3f), state %016llx\n",
+            replay.frame, replay.frame_count, (unsigned long long)sim.tick,
+            sim.curr.position_feet.x, sim.curr.position_feet.y, sim.curr.position_feet.z,
+            (unsigned long long)replay_state_hash(&world, &sim.curr));
+        if (ticks.world) {
+            const BlockTickStats* ts = block_tick_stats(&ticks);
+            fprintf(stderr, "headless: block ticks %llu scheduled, %llu random, %llu changed, %d active chunks\n",
+                (unsigned long long)ts->scheduled_run, (unsigned long long)ts->random_run,
+                (unsigned long long)ts->changed, ts->active_chunks);
+        }
+        sim_shutdown(&sim);
+        block_tick_shutdown(&ticks);
+        replay_reader_close(&replay);
+    }
+
+    if (mem_stats) mem_log_report("headless");
+
+    bool ok = soft_renderer_write_ppm(out_path);
+    if (!ok) fprintf(stderr, "headless: failed to write %s\n", out_path);
+
+    mesh_free(&mesh);
+    world_shutdown(&world);
+    chunk_slab_shutdown();
+    renderer_shutdown(&renderer);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,474 @@
+#include "mem_track.h"
+#include "renderer.h"
+#include "soft_renderer.h"
+
+#include "block.h"
+#include "math4.h"
+#include "simd4.h"
+#include "thread.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct SoftVertex {
+    float x, y, z, w;
+    float u, v, shade;
+} SoftVertex;
+
+typedef struct SoftTri {
+    float ea[3], eb[3], ec[3];
+    bool top_left[3];
+    float inv_area;
+    float z[3];
+    float iw[3];
+    float uw[3], vw[3];
+    float shade[3];
+    int min_x, min_y, max_x, max_y;
+} SoftTri;
+
+typedef struct SoftBin {
+    uint32_t* tris;
+    size_t count;
+    size_t cap;
+} SoftBin;
+
+typedef struct SoftContext {
+    int width;
+    int height;
+    int stride;
+    uint32_t* color;
+    float* depth;
+
+    int tiles_x;
+    int tiles_y;
+    SoftBin* bins;
+    SoftTri* tris;
+    size_t tri_count;
+    size_t tri_cap;
+
+    uint32_t* atlas;
+    int atlas_w;
+    int atlas_h;
+    Vec3 light_dir;
+
+    int thread_count;
+    Mutex* tile_lock;
+    int next_tile;
+    uint64_t pixels_written[SOFT_MAX_THREADS];
+    SoftStats stats;
+} SoftContext;
+
+static SoftContext g_soft;
+
+static bool resize_targets(int width, int height) {
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    if (width == g_soft.width && height == g_soft.height && g_soft.color) return true;
+
+    int stride = (width + 3) & ~3;
+    int tiles_x = (width + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+    int tiles_y = (height + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+    uint32_t* color = (uint32_t*)mem_calloc(MEM_TAG_GPU_MIRROR, (size_t)stride * (size_t)height, sizeof(uint32_t));
+    float* depth = (float*)mem_calloc(MEM_TAG_GPU_MIRROR, (size_t)stride * (size_t)height, sizeof(float));
+    SoftBin* bins = (SoftBin*)mem_calloc(MEM_TAG_SCRATCH, (size_t)tiles_x * (size_t)tiles_y, sizeof(SoftBin));
+    if (!color || !depth || !bins) {
+        mem_free(MEM_TAG_GPU_MIRROR, color);
+        mem_free(MEM_TAG_GPU_MIRROR, depth);
+        mem_free(MEM_TAG_SCRATCH, bins);
+        return false;
+    }
+
+    for (int i = 0; i < g_soft.tiles_x * g_soft.tiles_y; i++) mem_free(MEM_TAG_SCRATCH, g_soft.bins[i].tris);
+    mem_free(MEM_TAG_SCRATCH, g_soft.bins);
+    mem_free(MEM_TAG_GPU_MIRROR, g_soft.color);
+    mem_free(MEM_TAG_GPU_MIRROR, g_soft.depth);
+
+    g_soft.width = width;
+    g_soft.height = height;
+    g_soft.stride = stride;
+    g_soft.color = color;
+    g_soft.depth = depth;
+    g_soft.bins = bins;
+    g_soft.tiles_x = tiles_x;
+    g_soft.tiles_y = tiles_y;
+    soft_renderer_clear(0);
+    return true;
+}
+
+bool renderer_init(Renderer* r) {
+    memset(r, 0, sizeof(*r));
+    memset(&g_soft, 0, sizeof(g_soft));
+    block_registry_init();
+
+    g_soft.atlas = block_build_atlas(&g_soft.atlas_w, &g_soft.atlas_h);
+    if (!g_soft.atlas) return false;
+    if (!mutex_create(&g_soft.tile_lock)) return false;
+    g_soft.light_dir = vec3_norm((Vec3){ -0.6f, 1.0f, -0.2f });
+    soft_renderer_set_threads(thread_hardware_concurrency());
+    return resize_targets(SOFT_DEFAULT_WIDTH, SOFT_DEFAULT_HEIGHT);
+}
+
+void renderer_shutdown(Renderer* r) {
+    if (!r) return;
+    for (int i = 0; i < g_soft.tiles_x * g_soft.tiles_y; i++) mem_free(MEM_TAG_SCRATCH, g_soft.bins[i].tris);
+    mem_free(MEM_TAG_SCRATCH, g_soft.bins);
+    mem_free(MEM_TAG_SCRATCH, g_soft.tris);
+    mem_free(MEM_TAG_GPU_MIRROR, g_soft.color);
+    mem_free(MEM_TAG_GPU_MIRROR, g_soft.depth);
+    mem_free(MEM_TAG_TEXTURE, g_soft.atlas);
+    if (g_soft.tile_lock) mutex_destroy(g_soft.tile_lock);
+    memset(&g_soft, 0, sizeof(g_soft));
+    memset(r, 0, sizeof(*r));
+}
+
+void renderer_resize(int width, int height) {
+    resize_targets(width, height);
+}
+
+void soft_renderer_set_threads(int count) {
+    if (count < 1) count = 1;
+    if (count > SOFT_MAX_THREADS) count = SOFT_MAX_THREADS;
+    g_soft.thread_count = count;
+}
+
+void soft_renderer_clear(uint32_t rgba) {
+    size_t n = (size_t)g_soft.stride * (size_t)g_soft.height;
+    for (size_t i = 0; i < n; i++) {
+        g_soft.color[i] = rgba;
+        g_soft.depth[i] = 1.0f;
+    }
+}
+
+const uint32_t* soft_renderer_pixels(int* out_w, int* out_h, int* out_stride) {
+    if (out_w) *out_w = g_soft.width;
+    if (out_h) *out_h = g_soft.height;
+    if (out_stride) *out_stride = g_soft.stride;
+    return g_soft.color;
+}
+
+bool soft_renderer_write_ppm(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    bool ok = fprintf(f, "P6\n%d %d\n255\n", g_soft.width, g_soft.height) > 0;
+    uint8_t* row = (uint8_t*)mem_alloc(MEM_TAG_SCRATCH, (size_t)g_soft.width * 3);
+    ok = ok && row;
+    for (int y = 0; ok && y < g_soft.height; y++) {
+        const uint32_t* src = &g_soft.color[(size_t)y * (size_t)g_soft.stride];
+        for (int x = 0; x < g_soft.width; x++) {
+            row[x * 3 + 0] = (uint8_t)(src[x] & 0xFF);
+            row[x * 3 + 1] = (uint8_t)((src[x] >> 8) & 0xFF);
+            row[x * 3 + 2] = (uint8_t)((src[x] >> 16) & 0xFF);
+        }
+        ok = fwrite(row, 3, (size_t)g_soft.width, f) == (size_t)g_soft.width;
+    }
+    mem_free(MEM_TAG_SCRATCH, row);
+    ok = (fclose(f) == 0) && ok;
+    return ok;
+}
+
+SoftStats soft_renderer_take_stats(void) {
+    SoftStats s = g_soft.stats;
+    memset(&g_soft.stats, 0, sizeof(g_soft.stats));
+    return s;
+}
+
+static bool bin_push(SoftBin* bin, uint32_t tri) {
+    if (bin->count == bin->cap) {
+        size_t cap = bin->cap ? bin->cap * 2 : 64;
+        uint32_t* p = (uint32_t*)mem_realloc(MEM_TAG_SCRATCH, bin->tris, cap * sizeof(uint32_t));
+        if (!p) return false;
+        bin->tris = p;
+        bin->cap = cap;
+    }
+    bin->tris[bin->count++] = tri;
+    return true;
+}
+
+static SoftTri* tri_alloc(void) {
+    if (g_soft.tri_count == g_soft.tri_cap) {
+        size_t cap = g_soft.tri_cap ? g_soft.tri_cap * 2 : 1024;
+        SoftTri* p = (SoftTri*)mem_realloc(MEM_TAG_SCRATCH, g_soft.tris, cap * sizeof(SoftTri));
+        if (!p) return NULL;
+        g_soft.tris = p;
+        g_soft.tri_cap = cap;
+    }
+    return &g_soft.tris[g_soft.tri_count++];
+}
+
+static float fmin3(float a, float b, float c) { return fminf(a, fminf(b, c)); }
+static float fmax3(float a, float b, float c) { return fmaxf(a, fmaxf(b, c)); }
+
+static void setup_triangle(const SoftVertex* a, const SoftVertex* b, const SoftVertex* c) {
+    const SoftVertex* v[3] = { a, b, c };
+    float sx[3], sy[3];
+    for (int i = 0; i < 3; i++) {
+        float iw = 1.0f / v[i]->w;
+        sx[i] = (v[i]->x * iw * 0.5f + 0.5f) * (float)g_soft.width;
+        sy[i] = (0.5f - v[i]->y * iw * 0.5f) * (float)g_soft.height;
+    }
+
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+    if (!(area < 0.0f)) return;
+
+    const SoftVertex* t1 = v[1];
+    v[1] = v[2];
+    v[2] = t1;
+    float tx = sx[1], ty = sy[1];
+    sx[1] = sx[2];
+    sy[1] = sy[2];
+    sx[2] = tx;
+    sy[2] = ty;
+    area = -area;
+
+    int min_x = (int)floorf(fmin3(sx[0], sx[1], sx[2]));
+    int min_y = (int)floorf(fmin3(sy[0], sy[1], sy[2]));
+    int max_x = (int)ceilf(fmax3(sx[0], sx[1], sx[2]));
+    int max_y = (int)ceilf(fmax3(sy[0], sy[1], sy[2]));
+    if (min_x < 0) min_x = 0;
+    if (min_y < 0) min_y = 0;
+    if (max_x > g_soft.width - 1) max_x = g_soft.width - 1;
+    if (max_y > g_soft.height - 1) max_y = g_soft.height - 1;
+    if (min_x > max_x || min_y > max_y) return;
+
+    uint32_t index = (uint32_t)g_soft.tri_count;
+    SoftTri* t = tri_alloc();
+    if (!t) return;
+
+    for (int e = 0; e < 3; e++) {
+        int i0 = (e + 1) % 3;
+        int i1 = (e + 2) % 3;
+        t->ea[e] = sy[i0] - sy[i1];
+        t->eb[e] = sx[i1] - sx[i0];
+        t->ec[e] = sx[i0] * sy[i1] - sy[i0] * sx[i1];
+        t->top_left[e] = t->ea[e] > 0.0f || (t->ea[e] == 0.0f && t->eb[e] < 0.0f);
+    }
+    t->inv_area = 1.0f / area;
+    for (int i = 0; i < 3; i++) {
+        float iw = 1.0f / v[i]->w;
+        t->z[i] = v[i]->z * iw;
+        t->iw[i] = iw;
+        t->uw[i] = v[i]->u * iw;
+        t->vw[i] = v[i]->v * iw;
+        t->shade[i] = v[i]->shade;
+    }
+    t->min_x = min_x;
+    t->min_y = min_y;
+    t->max_x = max_x;
+    t->max_y = max_y;
+
+    g_soft.stats.triangles_binned++;
+    for (int ty0 = min_y / SOFT_TILE_SIZE; ty0 <= max_y / SOFT_TILE_SIZE; ty0++) {
+        for (int tx0 = min_x / SOFT_TILE_SIZE; tx0 <= max_x / SOFT_TILE_SIZE; tx0++) {
+            bin_push(&g_soft.bins[ty0 * g_soft.tiles_x + tx0], index);
+            g_soft.stats.tile_refs++;
+        }
+    }
+}
+
+static SoftVertex lerp_vertex(const SoftVertex* a, const SoftVertex* b, float t) {
+    SoftVertex r;
+    r.x = a->x + (b->x - a->x) * t;
+    r.y = a->y + (b->y - a->y) * t;
+    r.z = a->z + (b->z - a->z) * t;
+    r.w = a->w + (b->w - a->w) * t;
+    r.u = a->u + (b->u - a->u) * t;
+    r.v = a->v + (b->v - a->v) * t;
+    r.shade = a->shade + (b->shade - a->shade) * t;
+    return r;
+}
+
+static void clip_and_setup(const SoftVertex* a, const SoftVertex* b, const SoftVertex* c) {
+    const SoftVertex* in[3] = { a, b, c };
+    if (a->x > a->w && b->x > b->w && c->x > c->w) return;
+    if (a->x < -a->w && b->x < -b->w && c->x < -c->w) return;
+    if (a->y > a->w && b->y > b->w && c->y > c->w) return;
+    if (a->y < -a->w && b->y < -b->w && c->y < -c->w) return;
+    if (a->z > a->w && b->z > b->w && c->z > c->w) return;
+
+    float d[3];
+    int inside = 0;
+    for (int i = 0; i < 3; i++) {
+        d[i] = in[i]->z + in[i]->w;
+        if (d[i] >= 0.0f) inside++;
+    }
+    if (inside == 0) return;
+    if (inside == 3) {
+        setup_triangle(a, b, c);
+        return;
+    }
+
+    SoftVertex poly[4];
+    int n = 0;
+    for (int i = 0; i < 3; i++) {
+        int j = (i + 1) % 3;
+        if (d[i] >= 0.0f) poly[n++] = *in[i];
+        if ((d[i] >= 0.0f) != (d[j] >= 0.0f)) poly[n++] = lerp_vertex(in[i], in[j], d[i] / (d[i] - d[j]));
+    }
+    for (int i = 1; i + 1 < n; i++) setup_triangle(&poly[0], &poly[i], &poly[i + 1]);
+}
+
+static uint32_t shade_texel(uint32_t texel, float shade) {
+    int s = (int)(shade * 256.0f);
+    uint32_t r = ((texel & 0xFF) * (uint32_t)s) >> 8;
+    uint32_t g = (((texel >> 8) & 0xFF) * (uint32_t)s) >> 8;
+    uint32_t b = (((texel >> 16) & 0xFF) * (uint32_t)s) >> 8;
+    if (r > 255) r = 255;
+    if (g > 255) g = 255;
+    if (b > 255) b = 255;
+    return r | (g << 8) | (b << 16) | (texel & 0xFF000000u);
+}
+
+static uint64_t raster_tile(int tile) {
+    int tx = tile % g_soft.tiles_x;
+    int ty = tile / g_soft.tiles_x;
+    int x0 = tx * SOFT_TILE_SIZE;
+    int y0 = ty * SOFT_TILE_SIZE;
+    int x1 = x0 + SOFT_TILE_SIZE < g_soft.width ? x0 + SOFT_TILE_SIZE : g_soft.width;
+    int y1 = y0 + SOFT_TILE_SIZE < g_soft.height ? y0 + SOFT_TILE_SIZE : g_soft.height;
+
+    const SoftBin* bin = &g_soft.bins[tile];
+    const F4 lane = f4_set(0.5f, 1.5f, 2.5f, 3.5f);
+    const F4 zero = f4_set1(0.0f);
+    uint64_t written = 0;
+
+    for (size_t i = 0; i < bin->count; i++) {
+        const SoftTri* t = &g_soft.tris[bin->tris[i]];
+        int bx0 = (t->min_x > x0 ? t->min_x : x0) & ~3;
+        int bx1 = t->max_x + 1 < x1 ? t->max_x + 1 : x1;
+        int by0 = t->min_y > y0 ? t->min_y : y0;
+        int by1 = t->max_y + 1 < y1 ? t->max_y + 1 : y1;
+
+        F4 ea[3], eb[3], ec[3];
+        for (int e = 0; e < 3; e++) {
+            ea[e] = f4_set1(t->ea[e]);
+            eb[e] = f4_set1(t->eb[e]);
+            ec[e] = f4_set1(t->ec[e]);
+        }
+        const F4 inv_area = f4_set1(t->inv_area);
+        const F4 z0 = f4_set1(t->z[0]), z1 = f4_set1(t->z[1]), z2 = f4_set1(t->z[2]);
+
+        for (int y = by0; y < by1; y++) {
+            F4 py = f4_set1((float)y + 0.5f);
+            F4 row[3];
+            for (int e = 0; e < 3; e++) row[e] = f4_add(f4_mul(eb[e], py), ec[e]);
+            float* depth_row = &g_soft.depth[(size_t)y * (size_t)g_soft.stride];
+            uint32_t* color_row = &g_soft.color[(size_t)y * (size_t)g_soft.stride];
+
+            for (int x = bx0; x < bx1; x += 4) {
+                F4 px = f4_add(f4_set1((float)x), lane);
+                F4 w[3];
+                int mask = x1 - x >= 4 ? 0xF : (1 << (x1 - x)) - 1;
+                for (int e = 0; e < 3; e++) {
+                    w[e] = f4_add(f4_mul(ea[e], px), row[e]);
+                    mask &= t->top_left[e] ? f4_ge(w[e], zero) : f4_gt(w[e], zero);
+                }
+                if (!mask) continue;
+
+                F4 z = f4_mul(f4_add(f4_add(f4_mul(w[0], z0), f4_mul(w[1], z1)), f4_mul(w[2], z2)), inv_area);
+                mask &= f4_lt(z, f4_load(&depth_row[x]));
+                if (!mask) continue;
+
+                float zs[4], w0s[4], w1s[4], w2s[4];
+                f4_store(zs, z);
+                f4_store(w0s, w[0]);
+                f4_store(w1s, w[1]);
+                f4_store(w2s, w[2]);
+                for (int k = 0; k < 4; k++) {
+                    if (!(mask & (1 << k))) continue;
+                    float b0 = w0s[k] * t->inv_area;
+                    float b1 = w1s[k] * t->inv_area;
+                    float b2 = w2s[k] * t->inv_area;
+                    float iw = b0 * t->iw[0] + b1 * t->iw[1] + b2 * t->iw[2];
+                    float u = (b0 * t->uw[0] + b1 * t->uw[1] + b2 * t->uw[2]) / iw;
+                    float v = (b0 * t->vw[0] + b1 * t->vw[1] + b2 * t->vw[2]) / iw;
+                    float shade = b0 * t->shade[0] + b1 * t->shade[1] + b2 * t->shade[2];
+
+                    int sx = (int)(u * (float)g_soft.atlas_w);
+                    int sy = (int)(v * (float)g_soft.atlas_h);
+                    if (sx < 0) sx = 0;
+                    if (sy < 0) sy = 0;
+                    if (sx >= g_soft.atlas_w) sx = g_soft.atlas_w - 1;
+                    if (sy >= g_soft.atlas_h) sy = g_soft.atlas_h - 1;
+                    uint32_t texel = g_soft.atlas[(size_t)sy * (size_t)g_soft.atlas_w + (size_t)sx];
+
+                    depth_row[x + k] = zs[k];
+                    color_row[x + k] = shade_texel(texel, shade);
+                    written++;
+                }
+            }
+        }
+    }
+    return written;
+}
+
+static void raster_worker(void* user) {
+    int index = (int)(intptr_t)user;
+    int tile_count = g_soft.tiles_x * g_soft.tiles_y;
+    uint64_t written = 0;
+    for (;;) {
+        mutex_lock(g_soft.tile_lock);
+        int tile = g_soft.next_tile++;
+        mutex_unlock(g_soft.tile_lock);
+        if (tile >= tile_count) break;
+        if (g_soft.bins[tile].count) written += raster_tile(tile);
+    }
+    g_soft.pixels_written[index] = written;
+}
+
+static void raster_all_tiles(void) {
+    Thread* threads[SOFT_MAX_THREADS];
+    int spawned = 0;
+    g_soft.next_tile = 0;
+    for (int i = 1; i < g_soft.thread_count; i++) {
+        if (!thread_create(&threads[spawned], raster_worker, (void*)(intptr_t)i)) break;
+        spawned++;
+    }
+    raster_worker((void*)(intptr_t)0);
+    for (int i = 0; i < spawned; i++) thread_join(threads[i]);
+
+    for (int i = 0; i <= spawned; i++) {
+        g_soft.stats.pixels_written += g_soft.pixels_written[i];
+        g_soft.pixels_written[i] = 0;
+    }
+}
+
+static float vertex_shade(const float* v) {
+    Vec3 n = { v[5], v[6], v[7] };
+    float ndl = n.x * g_soft.light_dir.x + n.y * g_soft.light_dir.y + n.z * g_soft.light_dir.z;
+    if (ndl < 0.2f) ndl = 0.2f;
+    float lit = v[8] > v[9] ? v[8] : v[9];
+    return ndl * (0.08f + 0.92f * lit * lit);
+}
+
+void renderer_draw_mesh(Renderer* r, const Mesh* mesh, Mat4 mvp) {
+    (void)r;
+    if (!g_soft.color || mesh->vertex_count < 3) return;
+
+    g_soft.tri_count = 0;
+    for (int i = 0; i < g_soft.tiles_x * g_soft.tiles_y; i++) g_soft.bins[i].count = 0;
+
+    size_t tri_total = mesh->vertex_count / 3;
+    g_soft.stats.triangles_in += tri_total;
+    for (size_t t = 0; t < tri_total; t++) {
+        SoftVertex sv[3];
+        for (int k = 0; k < 3; k++) {
+            const float* v = &mesh->vertices[(t * 3 + (size_t)k) * MESH_VERTEX_FLOATS];
+            Vec4 clip = mat4_mul_vec4(&mvp, (Vec4){ v[0], v[1], v[2], 1.0f });
+            sv[k].x = clip.x;
+            sv[k].y = clip.y;
+            sv[k].z = clip.z;
+            sv[k].w = clip.w;
+            sv[k].u = v[3];
+            sv[k].v = v[4];
+            sv[k].shade = vertex_shade(v);
+        }
+        clip_and_setup(&sv[0], &sv[1], &sv[2]);
+    }
+
+    if (g_soft.tri_count) raster_all_tiles();
+}
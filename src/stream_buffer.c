@@ -0,0 +1,130 @@
+#include "stream_buffer.h"
+
+#include "gl_loader.h"
+#include "gl_state.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define STREAM_WAIT_TIMEOUT_NS 1000000000ull
+
+static void fence_push(StreamBuffer* sb) {
+    if (sb->pending == 0) return;
+    int slot = (sb->fence_first + sb->fence_count) % STREAM_BUFFER_MAX_FENCES;
+    sb->fences[slot].sync = (void*)glFenceSync_(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    sb->fences[slot].bytes = sb->pending;
+    sb->fence_count++;
+    sb->pending = 0;
+}
+
+static void fence_wait_oldest(StreamBuffer* sb) {
+    StreamFence* f = &sb->fences[sb->fence_first];
+    GLsync sync = (GLsync)f->sync;
+    if (sync) {
+        GLenum r = glClientWaitSync_(sync, 0, 0);
+        if (r != GL_ALREADY_SIGNALED && r != GL_CONDITION_SATISFIED) {
+            sb->stats.fence_waits++;
+            while (r != GL_ALREADY_SIGNALED && r != GL_CONDITION_SATISFIED && r != GL_WAIT_FAILED) {
+                r = glClientWaitSync_(sync, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_WAIT_TIMEOUT_NS);
+            }
+        }
+        glDeleteSync_(sync);
+    }
+    sb->used -= f->bytes;
+    f->sync = NULL;
+    f->bytes = 0;
+    sb->fence_first = (sb->fence_first + 1) % STREAM_BUFFER_MAX_FENCES;
+    sb->fence_count--;
+}
+
+bool stream_buffer_init(StreamBuffer* sb, size_t size) {
+    memset(sb, 0, sizeof(*sb));
+
+    GLuint buf = 0;
+    glGenBuffers_(1, &buf);
+    if (!buf) return false;
+    sb->buffer = (uint32_t)buf;
+    sb->size = size;
+
+    gl_state_bind_buffer(GL_COPY_WRITE_BUFFER, buf);
+    if (gl_has_buffer_storage()) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage_(GL_COPY_WRITE_BUFFER, (GLsizeiptr)size, NULL, flags);
+        sb->mapped = (uint8_t*)glMapBufferRange_(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)size, flags);
+        sb->persistent = sb->mapped != NULL;
+        if (!sb->persistent) {
+            gl_state_delete_buffer(buf);
+            buf = 0;
+            glGenBuffers_(1, &buf);
+            if (!buf) return false;
+            sb->buffer = (uint32_t)buf;
+            gl_state_bind_buffer(GL_COPY_WRITE_BUFFER, buf);
+        }
+    }
+    if (!sb->persistent) {
+        glBufferData_(GL_COPY_WRITE_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
+    }
+    return true;
+}
+
+void stream_buffer_shutdown(StreamBuffer* sb) {
+    if (!sb) return;
+    while (sb->fence_count > 0) {
+        StreamFence* f = &sb->fences[sb->fence_first];
+        if (f->sync) glDeleteSync_((GLsync)f->sync);
+        sb->fence_first = (sb->fence_first + 1) % STREAM_BUFFER_MAX_FENCES;
+        sb->fence_count--;
+    }
+    if (sb->buffer) {
+        GLuint b = (GLuint)sb->buffer;
+        if (sb->persistent) {
+            gl_state_bind_buffer(GL_COPY_WRITE_BUFFER, b);
+            glUnmapBuffer_(GL_COPY_WRITE_BUFFER);
+        }
+        gl_state_delete_buffer(b);
+    }
+    memset(sb, 0, sizeof(*sb));
+}
+
+bool stream_buffer_write(StreamBuffer* sb, const void* data, size_t bytes, size_t align, size_t* out_offset) {
+    if (!sb->buffer || bytes == 0 || bytes > sb->size) return false;
+    if (align == 0) align = 1;
+
+    size_t offset = 0;
+    size_t need = 0;
+    for (;;) {
+        if (sb->used == 0) sb->head = 0;
+        offset = (sb->head + align - 1) / align * align;
+        if (offset + bytes > sb->size) offset = 0;
+        need = (offset >= sb->head ? offset - sb->head : sb->size - sb->head) + bytes;
+        if (sb->used + need <= sb->size) break;
+        if (sb->fence_count == 0) fence_push(sb);
+        if (sb->fence_count == 0) return false;
+        fence_wait_oldest(sb);
+    }
+
+    if (sb->persistent) {
+        memcpy(sb->mapped + offset, data, bytes);
+    } else {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        gl_state_bind_buffer(GL_COPY_WRITE_BUFFER, (GLuint)sb->buffer);
+        void* dst = glMapBufferRange_(GL_COPY_WRITE_BUFFER, (GLintptr)offset, (GLsizeiptr)bytes, flags);
+        if (!dst) return false;
+        memcpy(dst, data, bytes);
+        glUnmapBuffer_(GL_COPY_WRITE_BUFFER);
+    }
+
+    sb->used += need;
+    sb->pending += need;
+    sb->head = offset + bytes;
+    sb->stats.bytes_written += bytes;
+    *out_offset = offset;
+    return true;
+}
+
+void stream_buffer_end_frame(StreamBuffer* sb) {
+    if (!sb->buffer) return;
+    if (sb->fence_count == STREAM_BUFFER_MAX_FENCES) fence_wait_oldest(sb);
+    fence_push(sb);
+}
@@ -0,0 +1,195 @@
+#include "terrain.h"
+
+#include "light.h"
+#include "simd4.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LATTICE_X (CHUNK_SIZE / TERRAIN_CELL_X + 1)
+#define LATTICE_Y (CHUNK_SIZE / TERRAIN_CELL_Y + 1)
+#define LATTICE_Z (CHUNK_SIZE / TERRAIN_CELL_Z + 1)
+
+#define TERRAIN_SURFACE_BASE 11.0f
+#define TERRAIN_DIRT_DEPTH 3
+
+static uint32_t hash3(int x, int y, int z, uint64_t seed) {
+    uint64_t h = seed * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)(uint32_t)x * 0xC2B2AE3D27D4EB4Full;
+    h ^= (uint64_t)(uint32_t)y * 0x165667B19E3779F9ull;
+    h ^= (uint64_t)(uint32_t)z * 0x27D4EB2F165667C5ull;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 32;
+    return (uint32_t)h;
+}
+
+static float lattice_value(int x, int y, int z, uint64_t seed) {
+    return (float)(hash3(x, y, z, seed) >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+static float smooth(float t) {
+    return t * t * (3.0f - 2.0f * t);
+}
+
+static float lerpf(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+static float value_noise3(uint64_t seed, float x, float y, float z) {
+    float fx = floorf(x), fy = floorf(y), fz = floorf(z);
+    int ix = (int)fx, iy = (int)fy, iz = (int)fz;
+    float tx = smooth(x - fx), ty = smooth(y - fy), tz = smooth(z - fz);
+
+    float c000 = lattice_value(ix, iy, iz, seed);
+    float c100 = lattice_value(ix + 1, iy, iz, seed);
+    float c010 = lattice_value(ix, iy + 1, iz, seed);
+    float c110 = lattice_value(ix + 1, iy + 1, iz, seed);
+    float c001 = lattice_value(ix, iy, iz + 1, seed);
+    float c101 = lattice_value(ix + 1, iy, iz + 1, seed);
+    float c011 = lattice_value(ix, iy + 1, iz + 1, seed);
+    float c111 = lattice_value(ix + 1, iy + 1, iz + 1, seed);
+
+    float x00 = lerpf(c000, c100, tx);
+    float x10 = lerpf(c010, c110, tx);
+    float x01 = lerpf(c001, c101, tx);
+    float x11 = lerpf(c011, c111, tx);
+    return lerpf(lerpf(x00, x10, ty), lerpf(x01, x11, ty), tz);
+}
+
+float terrain_density(uint64_t seed, float x, float y, float z) {
+    float surface = TERRAIN_SURFACE_BASE
+        + 5.0f * value_noise3(seed, x / 32.0f, 0.0f, z / 32.0f)
+        + 2.0f * value_noise3(seed + 1, x / 12.0f, 0.0f, z / 12.0f);
+    float d = (surface - y) * 0.25f;
+    d += 1.0f * value_noise3(seed + 2, x / 16.0f, y / 10.0f, z / 16.0f);
+
+    float cave = fabsf(value_noise3(seed + 3, x / 14.0f, y / 8.0f, z / 14.0f));
+    if (cave < 0.1f) d -= (0.1f - cave) * 40.0f;
+    return d;
+}
+
+static void clear_chunk_blocks(Chunk* c, int y0, int nx, int nz) {
+    memset(c->blocks, BLOCK_AIR, sizeof(c->blocks));
+    if (y0 != 0) return;
+    for (int lz = 0; lz < nz; lz++) memset(&c->blocks[chunk_local_index(0, 0, lz)], BLOCK_STONE, (size_t)nx);
+}
+
+static int chunk_limit(int extent, int origin) {
+    int n = extent - origin;
+    return n < CHUNK_SIZE ? n : CHUNK_SIZE;
+}
+
+void terrain_fill_chunk(World* world, int cx, int cy, int cz, uint64_t seed) {
+    Chunk* c = world_chunk_write(world, cx, cy, cz);
+    int x0 = cx << CHUNK_SHIFT;
+    int y0 = cy << CHUNK_SHIFT;
+    int z0 = cz << CHUNK_SHIFT;
+    int nx = chunk_limit(world->w, x0);
+    int ny = chunk_limit(world->h, y0);
+    int nz = chunk_limit(world->d, z0);
+    clear_chunk_blocks(c, y0, nx, nz);
+
+    float lattice[LATTICE_Y][LATTICE_Z][LATTICE_X + 3];
+    memset(lattice, 0, sizeof(lattice));
+    for (int j = 0; j < LATTICE_Y; j++) {
+        for (int k = 0; k < LATTICE_Z; k++) {
+            for (int i = 0; i < LATTICE_X; i++) {
+                lattice[j][k][i] = terrain_density(seed,
+                    (float)(x0 + i * TERRAIN_CELL_X), (float)(y0 + j * TERRAIN_CELL_Y), (float)(z0 + k * TERRAIN_CELL_Z));
+            }
+        }
+    }
+
+    const F4 zero = f4_set1(0.0f);
+    const F4 ramp = f4_set(0.0f, 0.25f, 0.5f, 0.75f);
+    float plane[LATTICE_Z][LATTICE_X + 3];
+    float row[LATTICE_X + 3];
+
+    for (int ly = 0; ly < ny; ly++) {
+        int j = ly / TERRAIN_CELL_Y;
+        F4 ty = f4_set1((float)(ly % TERRAIN_CELL_Y) / (float)TERRAIN_CELL_Y);
+        for (int k = 0; k < LATTICE_Z; k++) {
+            for (int i = 0; i < LATTICE_X; i += 4) {
+                F4 a = f4_load(&lattice[j][k][i]);
+                F4 b = f4_load(&lattice[j + 1][k][i]);
+                f4_store(&plane[k][i], f4_add(a, f4_mul(f4_sub(b, a), ty)));
+            }
+        }
+
+        for (int lz = 0; lz < nz; lz++) {
+            int k = lz / TERRAIN_CELL_Z;
+            F4 tz = f4_set1((float)(lz % TERRAIN_CELL_Z) / (float)TERRAIN_CELL_Z);
+            for (int i = 0; i < LATTICE_X; i += 4) {
+                F4 a = f4_load(&plane[k][i]);
+                F4 b = f4_load(&plane[k + 1][i]);
+                f4_store(&row[i], f4_add(a, f4_mul(f4_sub(b, a), tz)));
+            }
+
+            uint8_t* dst = &c->blocks[chunk_local_index(0, ly, lz)];
+            for (int i = 0; i * TERRAIN_CELL_X < nx; i++) {
+                F4 a = f4_set1(row[i]);
+                F4 b = f4_set1(row[i + 1]);
+                int mask = f4_gt(f4_add(a, f4_mul(f4_sub(b, a), ramp)), zero);
+                for (int lane = 0; lane < TERRAIN_CELL_X; lane++) {
+                    int lx = i * TERRAIN_CELL_X + lane;
+                    if (lx < nx && (mask & (1 << lane))) dst[lx] = BLOCK_STONE;
+                }
+            }
+        }
+    }
+}
+
+void terrain_fill_chunk_ref(World* world, int cx, int cy, int cz, uint64_t seed) {
+    Chunk* c = world_chunk_write(world, cx, cy, cz);
+    int x0 = cx << CHUNK_SHIFT;
+    int y0 = cy << CHUNK_SHIFT;
+    int z0 = cz << CHUNK_SHIFT;
+    int nx = chunk_limit(world->w, x0);
+    int ny = chunk_limit(world->h, y0);
+    int nz = chunk_limit(world->d, z0);
+    clear_chunk_blocks(c, y0, nx, nz);
+    for (int ly = 0; ly < ny; ly++) {
+        for (int lz = 0; lz < nz; lz++) {
+            for (int lx = 0; lx < nx; lx++) {
+                if (terrain_density(seed, (float)(x0 + lx), (float)(y0 + ly), (float)(z0 + lz)) > 0.0f) {
+                    c->blocks[chunk_local_index(lx, ly, lz)] = BLOCK_STONE;
+                }
+            }
+        }
+    }
+}
+
+void terrain_paint_surface(World* world) {
+    for (int z = 0; z < world->d; z++) {
+        for (int x = 0; x < world->w; x++) {
+            int depth = -1;
+            for (int y = world_height(world, x, z, HEIGHTMAP_SOLID); y >= 0; y--) {
+                Chunk* c = world_chunk_write(world, x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+                uint8_t* cell = &c->blocks[chunk_local_index(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)];
+                if (*cell == BLOCK_AIR) {
+                    if (depth >= 0) break;
+                    continue;
+                }
+                depth++;
+                if (depth > TERRAIN_DIRT_DEPTH) break;
+                *cell = (uint8_t)(depth == 0 ? BLOCK_GRASS : BLOCK_DIRT);
+            }
+        }
+    }
+}
+
+void world_generate_terrain(World* world, uint64_t seed) {
+    world->light_ready = false;
+    int n = world_chunk_count(world);
+    for (int i = 0; i < n; i++) {
+        int cx, cy, cz;
+        world_chunk_coords(world, i, &cx, &cy, &cz);
+        terrain_fill_chunk(world, cx, cy, cz, seed);
+    }
+    world_build_heightmaps(world);
+    terrain_paint_surface(world);
+    light_compute_world(world);
+}
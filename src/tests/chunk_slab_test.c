@@ -0,0 +1,169 @@
+#include "chunk_slab.h"
+#include "thread.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SLAB_TEST_THREADS 8
+#define SLAB_TEST_ITERATIONS 100000
+#define SLAB_TEST_HELD 256
+#define SLAB_TEST_PHASE 512
+#define SLAB_TEST_EXCHANGE 64
+
+typedef struct SlabTestWorker {
+    Thread* thread;
+    uint32_t id;
+    uint64_t rng;
+    int failures;
+} SlabTestWorker;
+
+static Mutex* g_exchange_lock;
+static Chunk* g_exchange[SLAB_TEST_EXCHANGE];
+static int g_exchange_count;
+
+static uint32_t next_rand(uint64_t* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return (uint32_t)(*s >> 32);
+}
+
+static void stamp(Chunk* chunk, uint32_t tag) {
+    memcpy(chunk->blocks, &tag, sizeof(tag));
+    memcpy(chunk->blocks + CHUNK_VOLUME - sizeof(tag), &tag, sizeof(tag));
+    memcpy(chunk->light, &tag, sizeof(tag));
+}
+
+static bool stamped(const Chunk* chunk, uint32_t tag) {
+    return memcmp(chunk->blocks, &tag, sizeof(tag)) == 0 &&
+        memcmp(chunk->blocks + CHUNK_VOLUME - sizeof(tag), &tag, sizeof(tag)) == 0 &&
+        memcmp(chunk->light, &tag, sizeof(tag)) == 0;
+}
+
+static bool release_checked(SlabTestWorker* w, Chunk* chunk, uint32_t tag) {
+    if (!stamped(chunk, tag) || chunk_slab_refs(chunk) != 1) {
+        if (w->failures++ < 5) fprintf(stderr, "chunk_slab_test: thread %u found a chunk it does not own\n", w->id);
+        return false;
+    }
+    stamp(chunk, 0);
+    chunk_slab_release(chunk);
+    return true;
+}
+
+static void exchange_swap(Chunk** chunk) {
+    mutex_lock(g_exchange_lock);
+    if (g_exchange_count < SLAB_TEST_EXCHANGE) {
+        g_exchange[g_exchange_count++] = *chunk;
+        *chunk = NULL;
+    } else {
+        int i = g_exchange_count - 1;
+        Chunk* out = g_exchange[i];
+        g_exchange[i] = *chunk;
+        *chunk = out;
+    }
+    mutex_unlock(g_exchange_lock);
+}
+
+static void slab_worker(void* user) {
+    SlabTestWorker* w = (SlabTestWorker*)user;
+    Chunk* held[SLAB_TEST_HELD];
+    uint32_t tags[SLAB_TEST_HELD];
+    int count = 0;
+    uint32_t seq = 0;
+
+    for (int it = 0; it < SLAB_TEST_ITERATIONS; it++) {
+        uint32_t r = next_rand(&w->rng);
+        bool filling = (it / SLAB_TEST_PHASE) % 2 == 0;
+        if (count == 0 || (count < SLAB_TEST_HELD && ((r & 3u) != 0) == filling)) {
+            Chunk* chunk = chunk_slab_alloc();
+            if (!chunk) {
+                if (w->failures++ < 5) fprintf(stderr, "chunk_slab_test: thread %u allocation failed\n", w->id);
+                continue;
+            }
+            tags[count] = (w->id << 24) | (++seq & 0xFFFFFFu);
+            stamp(chunk, tags[count]);
+            held[count++] = chunk;
+        } else {
+            int i = (int)(r >> 8) % count;
+            Chunk* chunk = held[i];
+            uint32_t tag = tags[i];
+            held[i] = held[--count];
+            tags[i] = tags[count];
+            if ((r & 0x30u) == 0) {
+                chunk_slab_retain(chunk);
+                chunk_slab_release(chunk);
+            }
+            if ((r & 0xC0u) == 0 && stamped(chunk, tag)) {
+                stamp(chunk, 0xFFFFFFFFu);
+                exchange_swap(&chunk);
+                if (chunk && !stamped(chunk, 0xFFFFFFFFu) && w->failures++ < 5) {
+                    fprintf(stderr, "chunk_slab_test: thread %u received a corrupted chunk\n", w->id);
+                }
+                if (chunk) chunk_slab_release(chunk);
+                continue;
+            }
+            release_checked(w, chunk, tag);
+        }
+    }
+    while (count > 0) {
+        count--;
+        release_checked(w, held[count], tags[count]);
+    }
+    chunk_slab_thread_flush();
+}
+
+int main(void) {
+    if (!mutex_create(&g_exchange_lock)) return 1;
+
+    SlabTestWorker workers[SLAB_TEST_THREADS];
+    memset(workers, 0, sizeof(workers));
+    int spawned = 0;
+    for (int i = 0; i < SLAB_TEST_THREADS; i++) {
+        workers[i].id = (uint32_t)i + 1;
+        workers[i].rng = 0x9E3779B97F4A7C15ull * (uint64_t)(i + 1);
+        if (!thread_create(&workers[i].thread, slab_worker, &workers[i])) break;
+        spawned++;
+    }
+    int failures = spawned == SLAB_TEST_THREADS ? 0 : 1;
+    for (int i = 0; i < spawned; i++) {
+        thread_join(workers[i].thread);
+        failures += workers[i].failures;
+    }
+    for (int i = 0; i < g_exchange_count; i++) chunk_slab_release(g_exchange[i]);
+    g_exchange_count = 0;
+    chunk_slab_thread_flush();
+
+    ChunkSlabStats s = chunk_slab_stats();
+    fprintf(stderr, "chunk_slab_test: %d threads, %llu allocs, %llu frees, %d slabs, %llu refills, %llu flushes\n", spawned,
+        (unsigned long long)s.allocs, (unsigned long long)s.frees, s.slabs, (unsigned long long)s.refills, (unsigned long long)s.flushes);
+    if (s.live != 0 || s.allocs != s.frees) {
+        fprintf(stderr, "chunk_slab_test: %d chunks still live\n", s.live);
+        failures++;
+    }
+
+    int capacity = s.slabs * CHUNK_SLAB_CHUNKS;
+    static Chunk* all[CHUNK_SLAB_MAX_SLABS * CHUNK_SLAB_CHUNKS];
+    int got = 0;
+    while (got < capacity) {
+        all[got] = chunk_slab_alloc();
+        if (!all[got]) break;
+        got++;
+    }
+    int slabs_after = chunk_slab_stats().slabs;
+    if (got != capacity || slabs_after != s.slabs) {
+        fprintf(stderr, "chunk_slab_test: allocating %d of %d free slots grew the pool from %d to %d slabs\n", got, capacity, s.slabs, slabs_after);
+        failures++;
+    }
+    for (int i = 0; i < got; i++) chunk_slab_release(all[i]);
+    chunk_slab_shutdown();
+    if (chunk_slab_stats().slabs != 0) {
+        fprintf(stderr, "chunk_slab_test: shutdown left slabs allocated\n");
+        failures++;
+    }
+
+    mutex_destroy(g_exchange_lock);
+    fprintf(stderr, "chunk_slab_test: %d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
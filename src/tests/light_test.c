@@ -0,0 +1,177 @@
+#include "block.h"
+#include "chunk_slab.h"
+#include "light.h"
+#include "mem_track.h"
+#include "world.h"
+#include "world_edit.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LIGHT_TEST_W 64
+#define LIGHT_TEST_H 64
+#define LIGHT_TEST_D 64
+#define LIGHT_TEST_OPERATIONS 400
+#define LIGHT_TEST_MAX_EDITS 256
+
+enum {
+    OP_SET,
+    OP_FILL_BOX,
+    OP_FILL_SPHERE,
+    OP_CARVE_SPHERE,
+    OP_APPLY_EDITS,
+    OP_PASTE_VOLUME,
+    OP_COUNT
+};
+
+static const char* g_op_names[OP_COUNT] = { "world_set", "world_fill_box", "world_fill_sphere", "world_carve_sphere", "world_apply_edits", "world_paste_volume" };
+
+static uint64_t g_rng = 0x853C49E6748FEA9Bull;
+static int g_failures;
+
+static uint32_t rand_u32(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return (uint32_t)(g_rng >> 32);
+}
+
+static int rand_range(int lo, int hi) {
+    return lo + (int)(rand_u32() % (uint32_t)(hi - lo + 1));
+}
+
+static BlockType rand_block(void) {
+    static const BlockType types[] = { BLOCK_AIR, BLOCK_AIR, BLOCK_AIR, BLOCK_STONE, BLOCK_STONE, BLOCK_DIRT, BLOCK_GRASS, BLOCK_SAND, BLOCK_LAMP, BLOCK_LAMP };
+    return types[rand_u32() % (sizeof(types) / sizeof(types[0]))];
+}
+
+static void rand_surface_cell(const World* world, int* x, int* y, int* z) {
+    *x = rand_range(0, world->w - 1);
+    *z = rand_range(0, world->d - 1);
+    int top = world_height(world, *x, *z, HEIGHTMAP_SOLID);
+    *y = rand_range(top - 6 > 0 ? top - 6 : 0, top + 6 < world->h - 1 ? top + 6 : world->h - 1);
+}
+
+static int apply_operation(World* world, BlockEdit* edits) {
+    int x, y, z;
+    rand_surface_cell(world, &x, &y, &z);
+    switch (rand_u32() % 7u) {
+    case 0:
+    case 1:
+        world_set(world, x, y, z, rand_block());
+        return OP_SET;
+    case 2: {
+        int x1 = x + rand_range(-10, 10);
+        int y1 = y + rand_range(-6, 6);
+        int z1 = z + rand_range(-10, 10);
+        world_fill_box(world, x, y, z, x1, y1, z1, rand_block());
+        return OP_FILL_BOX;
+    }
+    case 3:
+        world_fill_sphere(world, (float)x, (float)y, (float)z, (float)rand_range(1, 7), rand_block());
+        return OP_FILL_SPHERE;
+    case 4:
+        world_carve_sphere(world, (float)x, (float)y, (float)z, (float)rand_range(1, 9));
+        return OP_CARVE_SPHERE;
+    case 5: {
+        int count = rand_range(1, LIGHT_TEST_MAX_EDITS);
+        for (int i = 0; i < count; i++) {
+            edits[i].x = x + rand_range(-24, 24);
+            edits[i].y = y + rand_range(-8, 8);
+            edits[i].z = z + rand_range(-24, 24);
+            edits[i].type = rand_block();
+        }
+        world_apply_edits(world, edits, (size_t)count);
+        return OP_APPLY_EDITS;
+    }
+    default: {
+        BlockVolume volume;
+        int w = rand_range(1, 12);
+        int h = rand_range(1, 10);
+        int d = rand_range(1, 12);
+        if (!world_copy_volume(world, x, y, z, w, h, d, &volume)) return OP_PASTE_VOLUME;
+        int tx, ty, tz;
+        rand_surface_cell(world, &tx, &ty, &tz);
+        world_paste_volume(world, &volume, tx, ty, tz, (rand_u32() & 1u) != 0);
+        block_volume_free(&volume);
+        return OP_PASTE_VOLUME;
+    }
+    }
+}
+
+static void check_against_recompute(World* world, uint8_t* light, int16_t* heights, const char* what, int op) {
+    int n = world_chunk_count(world);
+    for (int i = 0; i < n; i++) memcpy(light + (size_t)i * CHUNK_VOLUME, world_chunk_at(world, i)->light, CHUNK_VOLUME);
+    for (int z = 0; z < world->d; z++) {
+        for (int x = 0; x < world->w; x++) {
+            for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) heights[(z * world->w + x) * HEIGHTMAP_KIND_COUNT + k] = (int16_t)world_height(world, x, z, (HeightmapKind)k);
+        }
+    }
+
+    world_build_heightmaps(world);
+    for (int z = 0; z < world->d; z++) {
+        for (int x = 0; x < world->w; x++) {
+            for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+                int expected = world_height(world, x, z, (HeightmapKind)k);
+                if (heights[(z * world->w + x) * HEIGHTMAP_KIND_COUNT + k] == expected) continue;
+                if (g_failures++ < 10) {
+                    fprintf(stderr, "light_test: op %d %s: heightmap %d at (%d, %d) is %d, rebuild gives %d\n", op, what, k, x, z,
+                        heights[(z * world->w + x) * HEIGHTMAP_KIND_COUNT + k], expected);
+                }
+                return;
+            }
+        }
+    }
+
+    light_compute_world(world);
+    for (int i = 0; i < n; i++) {
+        const uint8_t* full = world_chunk_at(world, i)->light;
+        const uint8_t* incremental = light + (size_t)i * CHUNK_VOLUME;
+        if (memcmp(full, incremental, CHUNK_VOLUME) == 0) continue;
+        for (int c = 0; c < CHUNK_VOLUME; c++) {
+            if (full[c] == incremental[c]) continue;
+            int cx, cy, cz;
+            world_chunk_coords(world, i, &cx, &cy, &cz);
+            int x = (cx << CHUNK_SHIFT) + (c & CHUNK_MASK);
+            int z = (cz << CHUNK_SHIFT) + ((c >> CHUNK_SHIFT) & CHUNK_MASK);
+            int y = (cy << CHUNK_SHIFT) + (c >> (2 * CHUNK_SHIFT));
+            if (g_failures++ < 10) {
+                fprintf(stderr, "light_test: op %d %s: light at (%d, %d, %d) is sky %d block %d, full recompute gives sky %d block %d\n", op, what,
+                    x, y, z, incremental[c] >> 4, incremental[c] & 0x0F, full[c] >> 4, full[c] & 0x0F);
+            }
+            return;
+        }
+    }
+}
+
+int main(void) {
+    block_registry_init();
+    World world;
+    if (!world_init(&world, LIGHT_TEST_W, LIGHT_TEST_H, LIGHT_TEST_D)) return 1;
+    world_generate(&world, WORLD_GEN_TERRAIN, 1234);
+    if (!world.light_ready) light_compute_world(&world);
+
+    int n = world_chunk_count(&world);
+    uint8_t* light = (uint8_t*)mem_alloc(MEM_TAG_SCRATCH, (size_t)n * CHUNK_VOLUME);
+    int16_t* heights = (int16_t*)mem_alloc(MEM_TAG_SCRATCH, (size_t)world.w * (size_t)world.d * HEIGHTMAP_KIND_COUNT * sizeof(int16_t));
+    BlockEdit* edits = (BlockEdit*)mem_alloc(MEM_TAG_SCRATCH, LIGHT_TEST_MAX_EDITS * sizeof(BlockEdit));
+    if (!light || !heights || !edits) return 1;
+
+    int counts[OP_COUNT] = { 0 };
+    for (int op = 0; op < LIGHT_TEST_OPERATIONS; op++) {
+        int kind = apply_operation(&world, edits);
+        counts[kind]++;
+        check_against_recompute(&world, light, heights, g_op_names[kind], op);
+    }
+
+    fprintf(stderr, "light_test: %d operations (%d set, %d box, %d sphere, %d carve, %d edits, %d paste), %d failure(s)\n", LIGHT_TEST_OPERATIONS,
+        counts[OP_SET], counts[OP_FILL_BOX], counts[OP_FILL_SPHERE], counts[OP_CARVE_SPHERE], counts[OP_APPLY_EDITS], counts[OP_PASTE_VOLUME], g_failures);
+    mem_free(MEM_TAG_SCRATCH, edits);
+    mem_free(MEM_TAG_SCRATCH, heights);
+    mem_free(MEM_TAG_SCRATCH, light);
+    world_shutdown(&world);
+    chunk_slab_shutdown();
+    return g_failures ? 1 : 0;
+}
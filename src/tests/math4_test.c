@@ -0,0 +1,191 @@
+#include "math4.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MATH4_TEST_ITERATIONS 2000
+#define MATH4_TEST_MAX_COUNT 37
+#define MATH4_TEST_TOLERANCE 1e-5f
+
+static uint64_t g_rng = 0x243F6A8885A308D3ull;
+static int g_failures;
+
+static float rand_float(float lo, float hi) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return lo + (hi - lo) * (float)(g_rng >> 40) / (float)(1u << 24);
+}
+
+static Mat4 rand_mat4(void) {
+    Mat4 m;
+    for (int i = 0; i < 16; i++) m.m[i] = rand_float(-4.0f, 4.0f);
+    return m;
+}
+
+static Vec3 rand_vec3(float extent) {
+    return (Vec3){ rand_float(-extent, extent), rand_float(-extent, extent), rand_float(-extent, extent) };
+}
+
+static Mat4 rand_view_proj(void) {
+    Vec3 eye = rand_vec3(64.0f);
+    Vec3 forward = rand_vec3(1.0f);
+    if (vec3_len(forward) < 0.1f) forward = (Vec3){ 0.0f, 0.0f, -1.0f };
+    Mat4 proj = mat4_perspective(rand_float(0.6f, 1.6f), rand_float(0.5f, 2.5f), 0.1f, rand_float(64.0f, 512.0f));
+    return mat4_mul(proj, mat4_look(eye, forward, (Vec3){ 0.0f, 1.0f, 0.0f }));
+}
+
+static bool close_to(float a, float b, float scale) {
+    return fabsf(a - b) <= MATH4_TEST_TOLERANCE * (1.0f + scale);
+}
+
+static void fail(const char* what, int iteration) {
+    if (g_failures < 10) fprintf(stderr, "math4_test: %s mismatch at iteration %d\n", what, iteration);
+    g_failures++;
+}
+
+static float vec4_scale(Vec4 v) {
+    return fabsf(v.x) + fabsf(v.y) + fabsf(v.z) + fabsf(v.w);
+}
+
+static void test_mat4_mul(int it) {
+    Mat4 a = rand_mat4();
+    Mat4 b = rand_mat4();
+    Mat4 ref;
+    mat4_mul_ref(&ref, &a, &b);
+    Mat4 got = mat4_mul(a, b);
+    Mat4 got_p;
+    mat4_mul_p(&got_p, &a, &b);
+    for (int i = 0; i < 16; i++) {
+        if (!close_to(got.m[i], ref.m[i], 64.0f) || !close_to(got_p.m[i], ref.m[i], 64.0f)) {
+            fail("mat4_mul", it);
+            return;
+        }
+    }
+}
+
+static bool vec4_close(Vec4 a, Vec4 b) {
+    float s = vec4_scale(b);
+    return close_to(a.x, b.x, s) && close_to(a.y, b.y, s) && close_to(a.z, b.z, s) && close_to(a.w, b.w, s);
+}
+
+static void test_mat4_mul_vec4(int it) {
+    Mat4 m = rand_mat4();
+    Vec4 v = { rand_float(-100.0f, 100.0f), rand_float(-100.0f, 100.0f), rand_float(-100.0f, 100.0f), rand_float(-2.0f, 2.0f) };
+    if (!vec4_close(mat4_mul_vec4(&m, v), mat4_mul_vec4_ref(&m, v))) fail("mat4_mul_vec4", it);
+}
+
+static void test_transform_points(int it) {
+    Mat4 m = rand_mat4();
+    Vec3 points[MATH4_TEST_MAX_COUNT];
+    Vec4 got[MATH4_TEST_MAX_COUNT];
+    Vec4 ref[MATH4_TEST_MAX_COUNT];
+    size_t count = (size_t)(it % (MATH4_TEST_MAX_COUNT + 1));
+    for (size_t i = 0; i < count; i++) points[i] = rand_vec3(100.0f);
+    mat4_transform_points(&m, points, got, count);
+    mat4_transform_points_ref(&m, points, ref, count);
+    for (size_t i = 0; i < count; i++) {
+        if (!vec4_close(got[i], ref[i])) {
+            fail("mat4_transform_points", it);
+            return;
+        }
+    }
+}
+
+static bool near_clip_boundary(Vec4 c) {
+    float eps = 1e-3f * (1.0f + fabsf(c.w));
+    return fabsf(c.w + c.x) < eps || fabsf(c.w - c.x) < eps ||
+        fabsf(c.w + c.y) < eps || fabsf(c.w - c.y) < eps ||
+        fabsf(c.w + c.z) < eps || fabsf(c.w - c.z) < eps;
+}
+
+static void test_frustum_planes(int it) {
+    Mat4 vp = rand_view_proj();
+    Vec4 planes[6];
+    mat4_frustum_planes(&vp, planes);
+    for (int k = 0; k < 64; k++) {
+        Vec3 p = rand_vec3(600.0f);
+        Vec4 c = mat4_mul_vec4_ref(&vp, (Vec4){ p.x, p.y, p.z, 1.0f });
+        if (near_clip_boundary(c)) continue;
+        bool ref_inside = c.x >= -c.w && c.x <= c.w && c.y >= -c.w && c.y <= c.w && c.z >= -c.w && c.z <= c.w;
+        bool inside = true;
+        for (int i = 0; i < 6; i++) {
+            if (planes[i].x * p.x + planes[i].y * p.y + planes[i].z * p.z + planes[i].w < 0.0f) inside = false;
+        }
+        if (inside != ref_inside) {
+            fail("mat4_frustum_planes", it);
+            return;
+        }
+    }
+}
+
+static float box_margin(const Vec4 planes[6], Vec3 mn, Vec3 mx) {
+    float margin = INFINITY;
+    for (int p = 0; p < 6; p++) {
+        const Vec4* pl = &planes[p];
+        float px = pl->x >= 0.0f ? mx.x : mn.x;
+        float py = pl->y >= 0.0f ? mx.y : mn.y;
+        float pz = pl->z >= 0.0f ? mx.z : mn.z;
+        float d = fabsf(pl->x * px + pl->y * py + pl->z * pz + pl->w);
+        if (d < margin) margin = d;
+    }
+    return margin;
+}
+
+static void test_aabb_cull(int it) {
+    Mat4 vp = rand_view_proj();
+    Vec4 planes[6];
+    mat4_frustum_planes(&vp, planes);
+
+    Vec3 mins[MATH4_TEST_MAX_COUNT];
+    Vec3 maxs[MATH4_TEST_MAX_COUNT];
+    uint8_t got[MATH4_TEST_MAX_COUNT + 1];
+    uint8_t ref[MATH4_TEST_MAX_COUNT + 1];
+    size_t count = (size_t)(it % (MATH4_TEST_MAX_COUNT + 1));
+    for (size_t i = 0; i < count; i++) {
+        mins[i] = rand_vec3(300.0f);
+        maxs[i] = vec3_add(mins[i], (Vec3){ rand_float(0.0f, 32.0f), rand_float(0.0f, 32.0f), rand_float(0.0f, 32.0f) });
+    }
+    memset(got, 0xCD, sizeof(got));
+    memset(ref, 0xCD, sizeof(ref));
+    size_t got_visible = aabb_cull_planes(planes, mins, maxs, got, count);
+    size_t ref_visible = aabb_cull_planes_ref(planes, mins, maxs, ref, count);
+
+    if (got[count] != 0xCD) {
+        fail("aabb_cull_planes tail overrun", it);
+        return;
+    }
+    size_t boundary = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (got[i] == ref[i]) continue;
+        if (box_margin(planes, mins[i], maxs[i]) > 1e-3f) {
+            fail("aabb_cull_planes", it);
+            return;
+        }
+        boundary++;
+    }
+    size_t diff = got_visible > ref_visible ? got_visible - ref_visible : ref_visible - got_visible;
+    if (diff > boundary) fail("aabb_cull_planes count", it);
+}
+
+int main(void) {
+#if defined(MATH4_SSE)
+    const char* path = "sse";
+#elif defined(MATH4_NEON)
+    const char* path = "neon";
+#else
+    const char* path = "scalar";
+#endif
+    for (int it = 0; it < MATH4_TEST_ITERATIONS; it++) {
+        test_mat4_mul(it);
+        test_mat4_mul_vec4(it);
+        test_transform_points(it);
+        test_frustum_planes(it);
+        test_aabb_cull(it);
+    }
+    fprintf(stderr, "math4_test: %s path, %d iterations, %d failure(s)\n", path, MATH4_TEST_ITERATIONS, g_failures);
+    return g_failures ? 1 : 0;
+}
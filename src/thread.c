@@ -0,0 +1,206 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "thread.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+struct Thread {
+    HANDLE handle;
+    ThreadFn fn;
+    void* user;
+};
+
+struct Mutex {
+    CRITICAL_SECTION cs;
+};
+
+struct CondVar {
+    CONDITION_VARIABLE cv;
+};
+
+static DWORD WINAPI thread_entry(LPVOID param) {
+    Thread* t = (Thread*)param;
+    t->fn(t->user);
+    return 0;
+}
+
+bool thread_create(Thread** out_thread, ThreadFn fn, void* user) {
+    if (!out_thread || !fn) return false;
+    *out_thread = NULL;
+    Thread* t = (Thread*)calloc(1, sizeof(Thread));
+    if (!t) return false;
+    t->fn = fn;
+    t->user = user;
+    t->handle = CreateThread(NULL, 0, thread_entry, t, 0, NULL);
+    if (!t->handle) {
+        free(t);
+        return false;
+    }
+    *out_thread = t;
+    return true;
+}
+
+void thread_join(Thread* thread) {
+    if (!thread) return;
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    free(thread);
+}
+
+void thread_sleep_ms(int ms) {
+    Sleep(ms > 0 ? (DWORD)ms : 0);
+}
+
+int thread_hardware_concurrency(void) {
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1;
+}
+
+bool mutex_create(Mutex** out_mutex) {
+    if (!out_mutex) return false;
+    Mutex* m = (Mutex*)calloc(1, sizeof(Mutex));
+    if (!m) return false;
+    InitializeCriticalSection(&m->cs);
+    *out_mutex = m;
+    return true;
+}
+
+void mutex_destroy(Mutex* mutex) {
+    if (!mutex) return;
+    DeleteCriticalSection(&mutex->cs);
+    free(mutex);
+}
+
+void mutex_lock(Mutex* mutex) { EnterCriticalSection(&mutex->cs); }
+void mutex_unlock(Mutex* mutex) { LeaveCriticalSection(&mutex->cs); }
+
+bool condvar_create(CondVar** out_cv) {
+    if (!out_cv) return false;
+    CondVar* cv = (CondVar*)calloc(1, sizeof(CondVar));
+    if (!cv) return false;
+    InitializeConditionVariable(&cv->cv);
+    *out_cv = cv;
+    return true;
+}
+
+void condvar_destroy(CondVar* cv) {
+    free(cv);
+}
+
+void condvar_wait(CondVar* cv, Mutex* mutex) { SleepConditionVariableCS(&cv->cv, &mutex->cs, INFINITE); }
+void condvar_signal(CondVar* cv) { WakeConditionVariable(&cv->cv); }
+void condvar_broadcast(CondVar* cv) { WakeAllConditionVariable(&cv->cv); }
+
+#else
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+struct Thread {
+    pthread_t handle;
+    ThreadFn fn;
+    void* user;
+};
+
+struct Mutex {
+    pthread_mutex_t m;
+};
+
+struct CondVar {
+    pthread_cond_t c;
+};
+
+static void* thread_entry(void* param) {
+    Thread* t = (Thread*)param;
+    t->fn(t->user);
+    return NULL;
+}
+
+bool thread_create(Thread** out_thread, ThreadFn fn, void* user) {
+    if (!out_thread || !fn) return false;
+    *out_thread = NULL;
+    Thread* t = (Thread*)calloc(1, sizeof(Thread));
+    if (!t) return false;
+    t->fn = fn;
+    t->user = user;
+    if (pthread_create(&t->handle, NULL, thread_entry, t) != 0) {
+        free(t);
+        return false;
+    }
+    *out_thread = t;
+    return true;
+}
+
+void thread_join(Thread* thread) {
+    if (!thread) return;
+    pthread_join(thread->handle, NULL);
+    free(thread);
+}
+
+void thread_sleep_ms(int ms) {
+    struct timespec ts;
+    if (ms < 0) ms = 0;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+int thread_hardware_concurrency(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+bool mutex_create(Mutex** out_mutex) {
+    if (!out_mutex) return false;
+    Mutex* m = (Mutex*)calloc(1, sizeof(Mutex));
+    if (!m) return false;
+    if (pthread_mutex_init(&m->m, NULL) != 0) {
+        free(m);
+        return false;
+    }
+    *out_mutex = m;
+    return true;
+}
+
+void mutex_destroy(Mutex* mutex) {
+    if (!mutex) return;
+    pthread_mutex_destroy(&mutex->m);
+    free(mutex);
+}
+
+void mutex_lock(Mutex* mutex) { pthread_mutex_lock(&mutex->m); }
+void mutex_unlock(Mutex* mutex) { pthread_mutex_unlock(&mutex->m); }
+
+bool condvar_create(CondVar** out_cv) {
+    if (!out_cv) return false;
+    CondVar* cv = (CondVar*)calloc(1, sizeof(CondVar));
+    if (!cv) return false;
+    if (pthread_cond_init(&cv->c, NULL) != 0) {
+        free(cv);
+        return false;
+    }
+    *out_cv = cv;
+    return true;
+}
+
+void condvar_destroy(CondVar* cv) {
+    if (!cv) return;
+    pthread_cond_destroy(&cv->c);
+    free(cv);
+}
+
+void condvar_wait(CondVar* cv, Mutex* mutex) { pthread_cond_wait(&cv->c, &mutex->m); }
+void condvar_signal(CondVar* cv) { pthread_cond_signal(&cv->c); }
+void condvar_broadcast(CondVar* cv) { pthread_cond_broadcast(&cv->c); }
+
+#endif
@@ -0,0 +1,185 @@
+#include "block.h"
+#include "chunk_slab.h"
+#include "light.h"
+#include "mem_track.h"
+#include "mesh.h"
+#include "terrain.h"
+#include "thread.h"
+#include "world.h"
+#include "world_save.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PREGEN_MAX_THREADS 64
+#define PREGEN_BATCH 8
+#define PREGEN_PROGRESS_INTERVAL 1.0
+
+typedef enum PregenStage {
+    PREGEN_FILL = 0,
+    PREGEN_MESH
+} PregenStage;
+
+typedef struct Pregen {
+    World* world;
+    uint64_t seed;
+    Mesh* meshes;
+    PregenStage stage;
+    int chunk_count;
+
+    Mutex* lock;
+    int next_chunk;
+    int done_chunks;
+} Pregen;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void pregen_worker(void* user) {
+    Pregen* p = (Pregen*)user;
+    int finished = 0;
+    for (;;) {
+        mutex_lock(p->lock);
+        p->done_chunks += finished;
+        int first = p->next_chunk;
+        p->next_chunk += PREGEN_BATCH;
+        mutex_unlock(p->lock);
+        if (first >= p->chunk_count) break;
+
+        int last = first + PREGEN_BATCH < p->chunk_count ? first + PREGEN_BATCH : p->chunk_count;
+        for (int i = first; i < last; i++) {
+            int cx, cy, cz;
+            world_chunk_coords(p->world, i, &cx, &cy, &cz);
+            if (p->stage == PREGEN_FILL) {
+                terrain_fill_chunk(p->world, cx, cy, cz, p->seed);
+            } else {
+                p->meshes[i] = world_build_chunk_mesh(p->world, cx, cy, cz);
+            }
+        }
+        finished = last - first;
+    }
+    chunk_slab_thread_flush();
+}
+
+static bool run_stage(Pregen* p, PregenStage stage, int thread_count, const char* label) {
+    p->stage = stage;
+    p->next_chunk = 0;
+    p->done_chunks = 0;
+
+    double t0 = now_seconds();
+    Thread* threads[PREGEN_MAX_THREADS];
+    int spawned = 0;
+    for (int i = 0; i < thread_count; i++) {
+        if (!thread_create(&threads[spawned], pregen_worker, p)) break;
+        spawned++;
+    }
+    if (spawned == 0) return false;
+
+    double last_report = t0;
+    for (;;) {
+        mutex_lock(p->lock);
+        int done = p->done_chunks;
+        mutex_unlock(p->lock);
+        if (done >= p->chunk_count) break;
+        double now = now_seconds();
+        if (now - last_report >= PREGEN_PROGRESS_INTERVAL) {
+            last_report = now;
+            fprintf(stderr, "pregen: %s %d/%d chunks (%.0f%%), %.0f chunks/s\n", label, done, p->chunk_count,
+                100.0 * (double)done / (double)p->chunk_count, (double)done / (now - t0));
+        }
+        thread_sleep_ms(10);
+    }
+    for (int i = 0; i < spawned; i++) thread_join(threads[i]);
+
+    double elapsed = now_seconds() - t0;
+    fprintf(stderr, "pregen: %s %d chunks in %.2f s, %.0f chunks/s on %d threads\n", label, p->chunk_count, elapsed,
+        (double)p->chunk_count / (elapsed > 0.0 ? elapsed : 1e-9), spawned);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* out_path = WORLD_SAVE_PATH;
+    uint64_t seed = 0;
+    int radius = 128;
+    int height = 32;
+    int threads = 0;
+    bool premesh = false;
+    bool mem_stats = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--radius") == 0 && i + 1 < argc) radius = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--mesh") == 0) premesh = true;
+        else if (strcmp(argv[i], "--mem-stats") == 0) mem_stats = true;
+    }
+    if (radius < 1 || height < 1) {
+        fprintf(stderr, "pregen: radius and height must be positive\n");
+        return 1;
+    }
+    if (threads <= 0) threads = thread_hardware_concurrency();
+    if (threads < 1) threads = 1;
+    if (threads > PREGEN_MAX_THREADS) threads = PREGEN_MAX_THREADS;
+
+    double t0 = now_seconds();
+    World world;
+    int side = (radius + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE * 2;
+    if (!world_init(&world, side, height, side)) {
+        fprintf(stderr, "pregen: cannot allocate a %dx%dx%d world\n", side, height, side);
+        return 1;
+    }
+
+    Pregen p;
+    memset(&p, 0, sizeof(p));
+    p.world = &world;
+    p.seed = seed;
+    p.chunk_count = world_chunk_count(&world);
+    if (!mutex_create(&p.lock)) {
+        world_shutdown(&world);
+        return 1;
+    }
+    fprintf(stderr, "pregen: seed %llu, %dx%dx%d blocks, %d chunks, %d threads\n", (unsigned long long)seed,
+        side, height, side, p.chunk_count, threads);
+
+    bool ok = run_stage(&p, PREGEN_FILL, threads, "fill");
+    if (ok) {
+        double tl = now_seconds();
+        world_build_heightmaps(&world);
+        terrain_paint_surface(&world);
+        light_compute_world(&world);
+        world_clear_dirty(&world);
+        fprintf(stderr, "pregen: surface and light in %.2f s\n", now_seconds() - tl);
+    }
+    if (ok && premesh) {
+        p.meshes = (Mesh*)mem_calloc(MEM_TAG_MESH, (size_t)p.chunk_count, sizeof(Mesh));
+        ok = p.meshes && run_stage(&p, PREGEN_MESH, threads, "mesh");
+    }
+
+    WorldSaveStats stats;
+    double tw = now_seconds();
+    ok = ok && world_save_write(&world, p.meshes, out_path, &stats);
+    if (ok) {
+        fprintf(stderr, "pregen: wrote %s, %llu KiB (%llu KiB blocks+light raw, %llu KiB meshes) in %.2f s\n", out_path,
+            (unsigned long long)(stats.file_bytes / 1024), (unsigned long long)(stats.raw_bytes / 1024),
+            (unsigned long long)(stats.mesh_bytes / 1024), now_seconds() - tw);
+        double total = now_seconds() - t0;
+        fprintf(stderr, "pregen: done in %.2f s, %.0f chunks/s overall\n", total, (double)p.chunk_count / total);
+    } else {
+        fprintf(stderr, "pregen: failed to generate or write %s\n", out_path);
+    }
+    if (mem_stats) mem_log_report("pregen");
+
+    world_free_chunk_meshes(p.meshes, p.chunk_count);
+    mutex_destroy(p.lock);
+    world_shutdown(&world);
+    chunk_slab_shutdown();
+    return ok ? 0 : 1;
+}
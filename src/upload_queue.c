@@ -0,0 +1,152 @@
+#include "upload_queue.h"
+
+#include "mem_track.h"
+#include "world.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UPLOAD_OUTSIDE_FRUSTUM 1.0e12f
+
+static const float* g_sort_keys;
+
+static int compare_keys(const void* a, const void* b) {
+    float ka = g_sort_keys[*(const int*)a];
+    float kb = g_sort_keys[*(const int*)b];
+    return (ka > kb) - (ka < kb);
+}
+
+bool upload_queue_init(UploadQueue* q, int slot_count, size_t byte_budget, double time_budget_ms, UploadClockFn clock) {
+    memset(q, 0, sizeof(*q));
+    size_t n = (size_t)(slot_count > 0 ? slot_count : 1);
+    q->meshes = (Mesh*)mem_calloc(MEM_TAG_MESH, n, sizeof(Mesh));
+    q->origins = (Vec3*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(Vec3));
+    q->queued = (uint8_t*)mem_calloc(MEM_TAG_SCRATCH, n, 1);
+    q->pending = (int*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(int));
+    q->order = (int*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(int));
+    q->keys = (float*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(float));
+    q->mins = (Vec3*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(Vec3));
+    q->maxs = (Vec3*)mem_calloc(MEM_TAG_SCRATCH, n, sizeof(Vec3));
+    q->visible = (uint8_t*)mem_calloc(MEM_TAG_SCRATCH, n, 1);
+    if (!q->meshes || !q->origins || !q->queued || !q->pending || !q->order || !q->keys || !q->mins || !q->maxs || !q->visible) {
+        upload_queue_shutdown(q);
+        return false;
+    }
+    q->slot_count = slot_count;
+    q->byte_budget = byte_budget;
+    q->time_budget_ms = time_budget_ms;
+    q->clock = clock;
+    return true;
+}
+
+void upload_queue_shutdown(UploadQueue* q) {
+    if (!q) return;
+    if (q->meshes) {
+        for (int i = 0; i < q->pending_count; i++) mesh_free(&q->meshes[q->pending[i]]);
+    }
+    mem_free(MEM_TAG_MESH, q->meshes);
+    mem_free(MEM_TAG_SCRATCH, q->origins);
+    mem_free(MEM_TAG_SCRATCH, q->queued);
+    mem_free(MEM_TAG_SCRATCH, q->pending);
+    mem_free(MEM_TAG_SCRATCH, q->order);
+    mem_free(MEM_TAG_SCRATCH, q->keys);
+    mem_free(MEM_TAG_SCRATCH, q->mins);
+    mem_free(MEM_TAG_SCRATCH, q->maxs);
+    mem_free(MEM_TAG_SCRATCH, q->visible);
+    memset(q, 0, sizeof(*q));
+}
+
+void upload_queue_submit(UploadQueue* q, int slot, Mesh mesh, Vec3 origin) {
+    if (slot < 0 || slot >= q->slot_count) {
+        mesh_free(&mesh);
+        return;
+    }
+    q->stats.submitted++;
+    if (q->queued[slot]) {
+        mesh_free(&q->meshes[slot]);
+        q->stats.superseded++;
+    } else {
+        q->queued[slot] = 1;
+        q->pending[q->pending_count++] = slot;
+    }
+    q->meshes[slot] = mesh;
+    q->origins[slot] = origin;
+    q->stats.pending = q->pending_count;
+}
+
+void upload_queue_cancel(UploadQueue* q, int slot) {
+    if (slot < 0 || slot >= q->slot_count || !q->queued[slot]) return;
+    mesh_free(&q->meshes[slot]);
+    q->queued[slot] = 0;
+    int left = 0;
+    for (int i = 0; i < q->pending_count; i++) {
+        if (q->pending[i] != slot) q->pending[left++] = q->pending[i];
+    }
+    q->pending_count = left;
+    q->stats.pending = left;
+}
+
+int upload_queue_flush(UploadQueue* q, Renderer* r, Vec3 eye, Mat4 view_proj) {
+    int n = q->pending_count;
+    if (n == 0) return 0;
+
+    const float half = (float)CHUNK_SIZE * 0.5f;
+    for (int i = 0; i < n; i++) {
+        Vec3 o = q->origins[q->pending[i]];
+        q->mins[i] = o;
+        q->maxs[i] = (Vec3){ o.x + (float)CHUNK_SIZE, o.y + (float)CHUNK_SIZE, o.z + (float)CHUNK_SIZE };
+    }
+    Vec4 planes[6];
+    mat4_frustum_planes(&view_proj, planes);
+    aabb_cull_planes(planes, q->mins, q->maxs, q->visible, (size_t)n);
+
+    for (int i = 0; i < n; i++) {
+        Vec3 o = q->origins[q->pending[i]];
+        float dx = o.x + half - eye.x;
+        float dy = o.y + half - eye.y;
+        float dz = o.z + half - eye.z;
+        float key = dx * dx + dy * dy + dz * dz;
+        q->keys[i] = q->visible[i] ? key : key + UPLOAD_OUTSIDE_FRUSTUM;
+        q->order[i] = i;
+    }
+    g_sort_keys = q->keys;
+    qsort(q->order, (size_t)n, sizeof(int), compare_keys);
+
+    double t0 = q->clock ? q->clock() : 0.0;
+    size_t bytes = 0;
+    int uploaded = 0;
+    for (int k = 0; k < n; k++) {
+        int slot = q->pending[q->order[k]];
+        Mesh* m = &q->meshes[slot];
+        size_t mesh_bytes = m->vertex_count * MESH_VERTEX_FLOATS * sizeof(float);
+        if (uploaded > 0) {
+            if (bytes + mesh_bytes > q->byte_budget) break;
+            if (q->clock && (q->clock() - t0) * 1000.0 >= q->time_budget_ms) break;
+        }
+        renderer_chunk_upload(r, slot, m, q->origins[slot]);
+        mesh_free(m);
+        q->queued[slot] = 0;
+        q->order[k] = -1;
+        bytes += mesh_bytes;
+        uploaded++;
+    }
+
+    int left = 0;
+    for (int k = 0; k < n; k++) {
+        if (q->order[k] >= 0) q->order[left++] = q->pending[q->order[k]];
+    }
+    memcpy(q->pending, q->order, (size_t)left * sizeof(int));
+    q->pending_count = left;
+
+    q->stats.uploaded += (uint64_t)uploaded;
+    q->stats.uploaded_bytes += bytes;
+    if (left > 0) q->stats.deferred_frames++;
+    q->stats.pending = left;
+    return uploaded;
+}
+
+const UploadQueueStats* upload_queue_stats(const UploadQueue* q) {
+    return &q->stats;
+}
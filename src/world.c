@@ -1,53 +1,180 @@
 #include "world.h"
 
+#include "block.h"
+#include "chunk_cache.h"
+#include "chunk_slab.h"
+#include "chunk_view.h"
+#include "light.h"
+#include "mem_track.h"
+#include "terrain.h"
+
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-static bool in_bounds(const World* world, int x, int y, int z) {
-    return x >= 0 && x < world->w && y >= 0 && y < world->h && z >= 0 && z < world->d;
-}
-
 bool world_init(World* world, int w, int h, int d) {
+    block_registry_init();
     memset(world, 0, sizeof(*world));
     world->w = w;
     world->h = h;
     world->d = d;
-    size_t n = (size_t)w * (size_t)h * (size_t)d;
-    world->blocks = (uint8_t*)malloc(n);
-    if (!world->blocks) return false;
-    memset(world->blocks, 0, n);
+    world->chunks_x = (w + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    world->chunks_y = (h + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    world->chunks_z = (d + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    size_t n = (size_t)world->chunks_x * (size_t)world->chunks_y * (size_t)world->chunks_z;
+    world->chunks = (Chunk**)mem_calloc(MEM_TAG_WORLD, n, sizeof(Chunk*));
+    if (!world->chunks) return false;
+    for (size_t i = 0; i < n; i++) {
+        world->chunks[i] = chunk_slab_calloc();
+        if (!world->chunks[i]) {
+            world_shutdown(world);
+            return false;
+        }
+    }
+    if (!world_alloc_heightmaps(world)) {
+        world_shutdown(world);
+        return false;
+    }
     return true;
 }
 
 void world_shutdown(World* world) {
     if (!world) return;
-    free(world->blocks);
-    world->blocks = NULL;
+    if (world->chunks && !world->chunks_external) {
+        int n = world_chunk_count(world);
+        for (int i = 0; i < n; i++) chunk_slab_release(world->chunks[i]);
+    }
+    mem_free(MEM_TAG_WORLD, world->chunks);
+    world->chunks = NULL;
+    mem_free(MEM_TAG_WORLD, world->columns);
+    world->columns = NULL;
+    world->chunks_external = false;
     world->w = world->h = world->d = 0;
+    world->chunks_x = world->chunks_y = world->chunks_z = 0;
+    world->light_ready = false;
+}
+
+bool world_adopt_external_chunks(World* world) {
+    if (!world->chunks_external) return true;
+    int n = world_chunk_count(world);
+    Chunk** copies = (Chunk**)mem_alloc(MEM_TAG_SCRATCH, (size_t)n * sizeof(Chunk*));
+    if (!copies) return false;
+    for (int i = 0; i < n; i++) {
+        copies[i] = chunk_slab_alloc();
+        if (!copies[i]) {
+            for (int k = 0; k < i; k++) chunk_slab_release(copies[k]);
+            mem_free(MEM_TAG_SCRATCH, copies);
+            return false;
+        }
+        memcpy(copies[i], world->chunks[i], sizeof(Chunk));
+    }
+    memcpy(world->chunks, copies, (size_t)n * sizeof(Chunk*));
+    mem_free(MEM_TAG_SCRATCH, copies);
+    world->chunks_external = false;
+    return true;
+}
+
+Chunk* world_chunk_write(World* world, int cx, int cy, int cz) {
+    int index = cx + world->chunks_x * (cz + world->chunks_z * cy);
+    Chunk* c = world_chunk_at(world, index);
+    if (world->chunks_external || chunk_slab_refs(c) == 1) return c;
+    Chunk* copy = chunk_slab_alloc();
+    if (!copy) {
+        fprintf(stderr, "world: cannot copy shared chunk %d\n", index);
+        abort();
+    }
+    memcpy(copy, c, sizeof(*copy));
+    world->chunks[index] = copy;
+    chunk_slab_release(c);
+    return copy;
 }
 
 BlockType world_get(const World* world, int x, int y, int z) {
-    if (!world || !world->blocks) return BLOCK_AIR;
-    if (!in_bounds(world, x, y, z)) return BLOCK_AIR;
-    size_t idx = (size_t)x + (size_t)world->w * ((size_t)z + (size_t)world->d * (size_t)y);
-    return (BlockType)world->blocks[idx];
+    if (!world || !world->chunks) return BLOCK_AIR;
+    if (!world_in_bounds(world, x, y, z)) return BLOCK_AIR;
+    const Chunk* c = world_chunk(world, x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+    return (BlockType)c->blocks[chunk_local_index(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)];
 }
 
 void world_set(World* world, int x, int y, int z, BlockType t) {
-    if (!world || !world->blocks) return;
-    if (!in_bounds(world, x, y, z)) return;
-    size_t idx = (size_t)x + (size_t)world->w * ((size_t)z + (size_t)world->d * (size_t)y);
-    world->blocks[idx] = (uint8_t)t;
+    if (!world || !world->chunks) return;
+    if (!world_in_bounds(world, x, y, z)) return;
+    Chunk* c = world_chunk_write(world, x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+    uint8_t* cell = &c->blocks[chunk_local_index(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)];
+    BlockType old_t = (BlockType)*cell;
+    if (old_t == t) return;
+    *cell = (uint8_t)t;
+    world_heightmap_update(world, x, y, z, t);
+    world_mark_dirty(world, x, y, z);
+    if (world->light_ready) light_update_block(world, x, y, z, old_t, t);
 }
 
 bool world_is_solid(BlockType t) {
-    return t != BLOCK_AIR;
+    return g_block_solid[(uint8_t)t] != 0;
+}
+
+bool world_is_opaque(BlockType t) {
+    return g_block_opaque[(uint8_t)t] != 0;
+}
+
+uint8_t world_light_emission(BlockType t) {
+    return g_block_emission[(uint8_t)t];
+}
+
+void world_mark_dirty(World* world, int x, int y, int z) {
+    int cx = x >> CHUNK_SHIFT;
+    int cy = y >> CHUNK_SHIFT;
+    int cz = z >> CHUNK_SHIFT;
+    int index = cx + world->chunks_x * (cz + world->chunks_z * cy);
+    world_mark_chunk_dirty(world, index);
+
+    int lx = x & CHUNK_MASK;
+    int ly = y & CHUNK_MASK;
+    int lz = z & CHUNK_MASK;
+    int row = world->chunks_x;
+    int layer = world->chunks_x * world->chunks_z;
+    if (lx == 0 && cx > 0) world_mark_chunk_dirty(world, index - 1);
+    if (lx == CHUNK_MASK && cx < world->chunks_x - 1) world_mark_chunk_dirty(world, index + 1);
+    if (ly == 0 && cy > 0) world_mark_chunk_dirty(world, index - layer);
+    if (ly == CHUNK_MASK && cy < world->chunks_y - 1) world_mark_chunk_dirty(world, index + layer);
+    if (lz == 0 && cz > 0) world_mark_chunk_dirty(world, index - row);
+    if (lz == CHUNK_MASK && cz < world->chunks_z - 1) world_mark_chunk_dirty(world, index + row);
+}
+
+void world_mark_chunk_dirty(World* world, int index) {
+    world_chunk_at(world, index)->dirty = true;
+    if (world->cache) chunk_cache_note_write(world->cache, index);
+}
+
+int world_take_dirty_chunks(World* world, int* out_indices, int max_indices) {
+    int n = world_chunk_count(world);
+    int taken = 0;
+    for (int i = 0; i < n && taken < max_indices; i++) {
+        Chunk* c = world->chunks[i];
+        if (!c || !c->dirty) continue;
+        c->dirty = false;
+        out_indices[taken++] = i;
+    }
+    return taken;
+}
+
+bool world_clear_dirty(World* world) {
+    bool any = false;
+    size_t n = (size_t)world->chunks_x * (size_t)world->chunks_y * (size_t)world->chunks_z;
+    for (size_t i = 0; i < n; i++) {
+        Chunk* c = world->chunks[i];
+        if (!c || !c->dirty) continue;
+        c->dirty = false;
+        any = true;
+    }
+    return any;
 }
 
 void world_generate_flat(World* world) {
+    world->light_ready = false;
     for (int z = 0; z < world->d; z++) {
         for (int x = 0; x < world->w; x++) {
             float nx = (float)x / (float)world->w;
@@ -68,6 +195,66 @@ void world_generate_flat(World* world) {
             }
         }
     }
+
+    light_compute_world(world);
+}
+
+void world_generate(World* world, WorldGenerator generator, uint64_t seed) {
+    if (generator == WORLD_GEN_TERRAIN) {
+        world_generate_terrain(world, seed);
+    } else {
+        world_generate_flat(world);
+    }
+}
+
+static const uint8_t* heightmap_table(HeightmapKind kind) {
+    return kind == HEIGHTMAP_SOLID ? g_block_solid : g_block_opaque;
+}
+
+bool world_alloc_heightmaps(World* world) {
+    size_t n = (size_t)world->chunks_x * (size_t)world->chunks_z;
+    world->columns = (ChunkColumnHeights*)mem_alloc(MEM_TAG_WORLD, n * sizeof(ChunkColumnHeights));
+    if (!world->columns) return false;
+    int16_t* p = &world->columns[0].top[0][0];
+    for (size_t i = 0; i < n * HEIGHTMAP_KIND_COUNT * CHUNK_COLUMN_AREA; i++) p[i] = -1;
+    return true;
+}
+
+void world_build_heightmaps(World* world) {
+    for (int z = 0; z < world->d; z++) {
+        for (int x = 0; x < world->w; x++) {
+            for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+                const uint8_t* table = heightmap_table((HeightmapKind)k);
+                int y = world->h - 1;
+                while (y >= 0 && !table[world_get(world, x, y, z)]) y--;
+                *world_column_top(world, x, z, (HeightmapKind)k) = (int16_t)y;
+            }
+        }
+    }
+}
+
+void world_heightmap_update(World* world, int x, int y, int z, BlockType t) {
+    for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+        const uint8_t* table = heightmap_table((HeightmapKind)k);
+        int16_t* top = world_column_top(world, x, z, (HeightmapKind)k);
+        if (table[t]) {
+            if (y > *top) *top = (int16_t)y;
+        } else if (y == *top) {
+            int ny = y - 1;
+            while (ny >= 0 && !table[world_get(world, x, ny, z)]) ny--;
+            *top = (int16_t)ny;
+        }
+    }
+}
+
+int world_height(const World* world, int x, int z, HeightmapKind kind) {
+    if (!world || !world->columns || x < 0 || x >= world->w || z < 0 || z >= world->d) return -1;
+    return *world_column_top(world, x, z, kind);
+}
+
+Vec3 world_spawn_point(const World* world) {
+    const int x = 12, z = 12;
+    return (Vec3){ (float)x, (float)(world_height(world, x, z, HEIGHTMAP_SOLID) + 1), (float)z };
 }
 
 typedef struct DynFloats {
@@ -79,7 +266,7 @@ typedef struct DynFloats {
 static void df_push(DynFloats* a, float v) {
     if (a->count + 1 > a->cap) {
         size_t new_cap = a->cap ? a->cap * 2 : 4096;
-        float* p = (float*)realloc(a->data, new_cap * sizeof(float));
+        float* p = (float*)mem_realloc(MEM_TAG_MESH, a->data, new_cap * sizeof(float));
         if (!p) return;
         a->data = p;
         a->cap = new_cap;
@@ -87,7 +274,7 @@ static void df_push(DynFloats* a, float v) {
     a->data[a->count++] = v;
 }
 
-static void push_vertex(DynFloats* a, float px, float py, float pz, float u, float v, float nx, float ny, float nz) {
+static void push_vertex(DynFloats* a, float px, float py, float pz, float u, float v, float nx, float ny, float nz, float sky, float blk) {
     df_push(a, px);
     df_push(a, py);
     df_push(a, pz);
@@ -96,126 +283,145 @@ static void push_vertex(DynFloats* a, float px, float py, float pz, float u, flo
     df_push(a, nx);
     df_push(a, ny);
     df_push(a, nz);
+    df_push(a, sky);
+    df_push(a, blk);
 }
 
-static void tile_uv(int tile_x, float local_u, float local_v, float* out_u, float* out_v) {
-    const float atlas_w = 64.0f;
-    const float atlas_h = 16.0f;
-    const float tile = 16.0f;
-    const float pad = 0.5f;
-
-    float u0 = (tile_x * tile + pad) / atlas_w;
-    float v0 = (0.0f + pad) / atlas_h;
-    float u1 = ((tile_x + 1) * tile - pad) / atlas_w;
-    float v1 = ((0.0f + 1.0f) * tile - pad) / atlas_h;
-
-    *out_u = u0 + (u1 - u0) * local_u;
-    *out_v = v0 + (v1 - v0) * local_v;
-}
-
-static int tile_for_face(BlockType t, int face) {
-    if (t == BLOCK_GRASS) {
-        if (face == 2) return 0;
-        if (face == 3) return 2;
-        return 1;
-    }
-    if (t == BLOCK_DIRT) return 2;
-    if (t == BLOCK_STONE) return 3;
-    return 3;
-}
-
-static void add_face(DynFloats* a, float x, float y, float z, int face, int tile_x) {
-    float u00, v00, u10, v10, u11, v11, u01, v01;
-    tile_uv(tile_x, 0.0f, 0.0f, &u00, &v00);
-    tile_uv(tile_x, 1.0f, 0.0f, &u10, &v10);
-    tile_uv(tile_x, 1.0f, 1.0f, &u11, &v11);
-    tile_uv(tile_x, 0.0f, 1.0f, &u01, &v01);
+static void add_face(DynFloats* a, float x, float y, float z, int face, int tile, float sky, float blk) {
+    const float* uv = g_tile_uv[tile];
+    float u00 = uv[0], v00 = uv[1];
+    float u10 = uv[2], v10 = uv[1];
+    float u11 = uv[2], v11 = uv[3];
+    float u01 = uv[0], v01 = uv[3];
 
     if (face == 0) {
-        push_vertex(a, x + 1, y + 0, z + 0, u00, v00, 1, 0, 0);
-        push_vertex(a, x + 1, y + 1, z + 0, u01, v01, 1, 0, 0);
-        push_vertex(a, x + 1, y + 1, z + 1, u11, v11, 1, 0, 0);
-        push_vertex(a, x + 1, y + 0, z + 0, u00, v00, 1, 0, 0);
-        push_vertex(a, x + 1, y + 1, z + 1, u11, v11, 1, 0, 0);
-        push_vertex(a, x + 1, y + 0, z + 1, u10, v10, 1, 0, 0);
+        push_vertex(a, x + 1, y + 0, z + 0, u00, v00, 1, 0, 0, sky, blk);
+        push_vertex(a, x + 1, y + 1, z + 0, u01, v01, 1, 0, 0, sky, blk);
+        push_vertex(a, x + 1, y + 1, z + 1, u11, v11, 1, 0, 0, sky, blk);
+        push_vertex(a, x + 1, y + 0, z + 0, u00, v00, 1, 0, 0, sky, blk);
+        push_vertex(a, x + 1, y + 1, z + 1, u11, v11, 1, 0, 0, sky, blk);
+        push_vertex(a, x + 1, y + 0, z + 1, u10, v10, 1, 0, 0, sky, blk);
         return;
     }
     if (face == 1) {
-        push_vertex(a, x + 0, y + 0, z + 1, u00, v00, -1, 0, 0);
-        push_vertex(a, x + 0, y + 1, z + 1, u01, v01, -1, 0, 0);
-        push_vertex(a, x + 0, y + 1, z + 0, u11, v11, -1, 0, 0);
-        push_vertex(a, x + 0, y + 0, z + 1, u00, v00, -1, 0, 0);
-        push_vertex(a, x + 0, y + 1, z + 0, u11, v11, -1, 0, 0);
-        push_vertex(a, x + 0, y + 0, z + 0, u10, v10, -1, 0, 0);
+        push_vertex(a, x + 0, y + 0, z + 1, u00, v00, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0, y + 1, z + 1, u01, v01, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0, y + 1, z + 0, u11, v11, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0, y + 0, z + 1, u00, v00, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0, y + 1, z + 0, u11, v11, -1, 0, 0, sky, blk);
+        push_vertex(a, x + 0, y + 0, z + 0, u10, v10, -1, 0, 0, sky, blk);
         return;
     }
     if (face == 2) {
-        push_vertex(a, x + 0, y + 1, z + 0, u00, v00, 0, 1, 0);
-        push_vertex(a, x + 0, y + 1, z + 1, u01, v01, 0, 1, 0);
-        push_vertex(a, x + 1, y + 1, z + 1, u11, v11, 0, 1, 0);
-        push_vertex(a, x + 0, y + 1, z + 0, u00, v00, 0, 1, 0);
-        push_vertex(a, x + 1, y + 1, z + 1, u11, v11, 0, 1, 0);
-        push_vertex(a, x + 1, y + 1, z + 0, u10, v10, 0, 1, 0);
+        push_vertex(a, x + 0, y + 1, z + 0, u00, v00, 0, 1, 0, sky, blk);
+        push_vertex(a, x + 0, y + 1, z + 1, u01, v01, 0, 1, 0, sky, blk);
+        push_vertex(a, x + 1, y + 1, z + 1, u11, v11, 0, 1, 0, sky, blk);
+        push_vertex(a, x + 0, y + 1, z + 0, u00, v00, 0, 1, 0, sky, blk);
+        push_vertex(a, x + 1, y + 1, z + 1, u11, v11, 0, 1, 0, sky, blk);
+        push_vertex(a, x + 1, y + 1, z + 0, u10, v10, 0, 1, 0, sky, blk);
         return;
     }
     if (face == 3) {
-        push_vertex(a, x + 1, y + 0, z + 0, u00, v00, 0, -1, 0);
-        push_vertex(a, x + 1, y + 0, z + 1, u01, v01, 0, -1, 0);
-        push_vertex(a, x + 0, y + 0, z + 1, u11, v11, 0, -1, 0);
-        push_vertex(a, x + 1, y + 0, z + 0, u00, v00, 0, -1, 0);
-        push_vertex(a, x + 0, y + 0, z + 1, u11, v11, 0, -1, 0);
-        push_vertex(a, x + 0, y + 0, z + 0, u10, v10, 0, -1, 0);
+        push_vertex(a, x + 1, y + 0, z + 0, u00, v00, 0, -1, 0, sky, blk);
+        push_vertex(a, x + 1, y + 0, z + 1, u01, v01, 0, -1, 0, sky, blk);
+        push_vertex(a, x + 0, y + 0, z + 1, u11, v11, 0, -1, 0, sky, blk);
+        push_vertex(a, x + 1, y + 0, z + 0, u00, v00, 0, -1, 0, sky, blk);
+        push_vertex(a, x + 0, y + 0, z + 1, u11, v11, 0, -1, 0, sky, blk);
+        push_vertex(a, x + 0, y + 0, z + 0, u10, v10, 0, -1, 0, sky, blk);
         return;
     }
     if (face == 4) {
-        push_vertex(a, x + 0, y + 0, z + 0, u00, v00, 0, 0, -1);
-        push_vertex(a, x + 0, y + 1, z + 0, u01, v01, 0, 0, -1);
-        push_vertex(a, x + 1, y + 1, z + 0, u11, v11, 0, 0, -1);
-        push_vertex(a, x + 0, y + 0, z + 0, u00, v00, 0, 0, -1);
-        push_vertex(a, x + 1, y + 1, z + 0, u11, v11, 0, 0, -1);
-        push_vertex(a, x + 1, y + 0, z + 0, u10, v10, 0, 0, -1);
+        push_vertex(a, x + 0, y + 0, z + 0, u00, v00, 0, 0, -1, sky, blk);
+        push_vertex(a, x + 0, y + 1, z + 0, u01, v01, 0, 0, -1, sky, blk);
+        push_vertex(a, x + 1, y + 1, z + 0, u11, v11, 0, 0, -1, sky, blk);
+        push_vertex(a, x + 0, y + 0, z + 0, u00, v00, 0, 0, -1, sky, blk);
+        push_vertex(a, x + 1, y + 1, z + 0, u11, v11, 0, 0, -1, sky, blk);
+        push_vertex(a, x + 1, y + 0, z + 0, u10, v10, 0, 0, -1, sky, blk);
         return;
     }
     if (face == 5) {
-        push_vertex(a, x + 1, y + 0, z + 1, u00, v00, 0, 0, 1);
-        push_vertex(a, x + 1, y + 1, z + 1, u01, v01, 0, 0, 1);
-        push_vertex(a, x + 0, y + 1, z + 1, u11, v11, 0, 0, 1);
-        push_vertex(a, x + 1, y + 0, z + 1, u00, v00, 0, 0, 1);
-        push_vertex(a, x + 0, y + 1, z + 1, u11, v11, 0, 0, 1);
-        push_vertex(a, x + 0, y + 0, z + 1, u10, v10, 0, 0, 1);
+        push_vertex(a, x + 1, y + 0, z + 1, u00, v00, 0, 0, 1, sky, blk);
+        push_vertex(a, x + 1, y + 1, z + 1, u01, v01, 0, 0, 1, sky, blk);
+        push_vertex(a, x + 0, y + 1, z + 1, u11, v11, 0, 0, 1, sky, blk);
+        push_vertex(a, x + 1, y + 0, z + 1, u00, v00, 0, 0, 1, sky, blk);
+        push_vertex(a, x + 0, y + 1, z + 1, u11, v11, 0, 0, 1, sky, blk);
+        push_vertex(a, x + 0, y + 0, z + 1, u10, v10, 0, 0, 1, sky, blk);
         return;
     }
 }
 
-Mesh world_build_mesh(const World* world) {
-    DynFloats verts = { 0 };
+static void emit_face(DynFloats* a, const ChunkView* view, int i, int offset, float x, float y, float z, int face, BlockType t) {
+    uint8_t packed = view->light[i + offset];
+    float sky = (float)(packed >> 4) / (float)LIGHT_MAX;
+    float blk = (float)(packed & 0x0F) / (float)LIGHT_MAX;
+    add_face(a, x, y, z, face, g_block_face_tile[t][face], sky, blk);
+}
 
-    for (int y = 0; y < world->h; y++) {
-        for (int z = 0; z < world->d; z++) {
-            for (int x = 0; x < world->w; x++) {
-                BlockType t = world_get(world, x, y, z);
-                if (!world_is_solid(t)) continue;
-
-                BlockType nxp = world_get(world, x + 1, y, z);
-                BlockType nxn = world_get(world, x - 1, y, z);
-                BlockType nyp = world_get(world, x, y + 1, z);
-                BlockType nyn = world_get(world, x, y - 1, z);
-                BlockType nzp = world_get(world, x, y, z + 1);
-                BlockType nzn = world_get(world, x, y, z - 1);
-
-                if (!world_is_solid(nxp)) add_face(&verts, (float)x, (float)y, (float)z, 0, tile_for_face(t, 0));
-                if (!world_is_solid(nxn)) add_face(&verts, (float)x, (float)y, (float)z, 1, tile_for_face(t, 1));
-                if (!world_is_solid(nyp)) add_face(&verts, (float)x, (float)y, (float)z, 2, tile_for_face(t, 2));
-                if (!world_is_solid(nyn)) add_face(&verts, (float)x, (float)y, (float)z, 3, tile_for_face(t, 3));
-                if (!world_is_solid(nzn)) add_face(&verts, (float)x, (float)y, (float)z, 4, tile_for_face(t, 4));
-                if (!world_is_solid(nzp)) add_face(&verts, (float)x, (float)y, (float)z, 5, tile_for_face(t, 5));
+static void mesh_view(DynFloats* verts, const ChunkView* view, int ox, int oy, int oz) {
+    const uint8_t* blocks = view->blocks;
+    for (int ly = 0; ly < view->size_y; ly++) {
+        for (int lz = 0; lz < view->size_z; lz++) {
+            int i = chunk_view_index(0, ly, lz);
+            for (int lx = 0; lx < view->size_x; lx++, i++) {
+                BlockType t = (BlockType)blocks[i];
+                if (!g_block_solid[t]) continue;
+
+                float x = (float)(view->x0 + lx - ox);
+                float y = (float)(view->y0 + ly - oy);
+                float z = (float)(view->z0 + lz - oz);
+                if (!g_block_opaque[blocks[i + CHUNK_VIEW_STRIDE_X]]) emit_face(verts, view, i, CHUNK_VIEW_STRIDE_X, x, y, z, 0, t);
+                if (!g_block_opaque[blocks[i - CHUNK_VIEW_STRIDE_X]]) emit_face(verts, view, i, -CHUNK_VIEW_STRIDE_X, x, y, z, 1, t);
+                if (!g_block_opaque[blocks[i + CHUNK_VIEW_STRIDE_Y]]) emit_face(verts, view, i, CHUNK_VIEW_STRIDE_Y, x, y, z, 2, t);
+                if (!g_block_opaque[blocks[i - CHUNK_VIEW_STRIDE_Y]]) emit_face(verts, view, i, -CHUNK_VIEW_STRIDE_Y, x, y, z, 3, t);
+                if (!g_block_opaque[blocks[i - CHUNK_VIEW_STRIDE_Z]]) emit_face(verts, view, i, -CHUNK_VIEW_STRIDE_Z, x, y, z, 4, t);
+                if (!g_block_opaque[blocks[i + CHUNK_VIEW_STRIDE_Z]]) emit_face(verts, view, i, CHUNK_VIEW_STRIDE_Z, x, y, z, 5, t);
             }
         }
     }
+}
 
+static Mesh mesh_from_verts(DynFloats* verts) {
     Mesh mesh = { 0 };
-    mesh.vertices = verts.data;
-    mesh.vertex_count = verts.count / 8;
+    mesh.vertices = verts->data;
+    mesh.vertex_count = verts->count / MESH_VERTEX_FLOATS;
     return mesh;
 }
 
+Mesh world_build_mesh(const World* world) {
+    DynFloats verts = { 0 };
+    ChunkView view;
+    int n = world_chunk_count(world);
+    for (int i = 0; i < n; i++) {
+        int cx, cy, cz;
+        world_chunk_coords(world, i, &cx, &cy, &cz);
+        chunk_view_gather(&view, world, cx, cy, cz);
+        mesh_view(&verts, &view, 0, 0, 0);
+    }
+    return mesh_from_verts(&verts);
+}
+
+Mesh world_build_chunk_mesh(const World* world, int cx, int cy, int cz) {
+    DynFloats verts = { 0 };
+    ChunkView view;
+    chunk_view_gather(&view, world, cx, cy, cz);
+    mesh_view(&verts, &view, view.x0, view.y0, view.z0);
+    return mesh_from_verts(&verts);
+}
+
+Mesh* world_build_chunk_meshes(const World* world) {
+    int n = world_chunk_count(world);
+    Mesh* meshes = (Mesh*)mem_calloc(MEM_TAG_MESH, (size_t)n, sizeof(Mesh));
+    if (!meshes) return NULL;
+    for (int i = 0; i < n; i++) {
+        int cx, cy, cz;
+        world_chunk_coords(world, i, &cx, &cy, &cz);
+        meshes[i] = world_build_chunk_mesh(world, cx, cy, cz);
+    }
+    return meshes;
+}
+
+void world_free_chunk_meshes(Mesh* meshes, int count) {
+    if (!meshes) return;
+    for (int i = 0; i < count; i++) mesh_free(&meshes[i]);
+    mem_free(MEM_TAG_MESH, meshes);
+}
@@ -0,0 +1,209 @@
+#include "world_edit.h"
+
+#include "light.h"
+#include "mem_track.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct EditBatch {
+    World* world;
+    bool track_light;
+    BlockPos* changed;
+    size_t count;
+    size_t cap;
+    int total;
+} EditBatch;
+
+static void batch_begin(EditBatch* b, World* world) {
+    memset(b, 0, sizeof(*b));
+    b->world = world;
+    b->track_light = world->light_ready;
+}
+
+static void batch_record(EditBatch* b, int x, int y, int z) {
+    b->total++;
+    if (!b->track_light) return;
+    if (b->count + 1 > b->cap) {
+        size_t new_cap = b->cap ? b->cap * 2 : 1024;
+        BlockPos* p = (BlockPos*)mem_realloc(MEM_TAG_SCRATCH, b->changed, new_cap * sizeof(BlockPos));
+        if (!p) {
+            b->track_light = false;
+            return;
+        }
+        b->changed = p;
+        b->cap = new_cap;
+    }
+    b->changed[b->count++] = (BlockPos){ x, y, z };
+}
+
+static int batch_end(EditBatch* b) {
+    if (b->world->light_ready) {
+        if (b->track_light) {
+            light_update_blocks(b->world, b->changed, b->count);
+        } else if (b->total > 0) {
+            light_compute_world(b->world);
+        }
+    }
+    mem_free(MEM_TAG_SCRATCH, b->changed);
+    return b->total;
+}
+
+static void batch_row(EditBatch* b, int y, int z, int x0, int x1, const uint8_t* src, uint8_t fill, bool skip_air) {
+    World* world = b->world;
+    int cy = y >> CHUNK_SHIFT;
+    int cz = z >> CHUNK_SHIFT;
+    int row = chunk_local_index(0, y & CHUNK_MASK, z & CHUNK_MASK);
+
+    for (int x = x0; x < x1;) {
+        int seg_end = ((x >> CHUNK_SHIFT) + 1) << CHUNK_SHIFT;
+        if (seg_end > x1) seg_end = x1;
+
+        uint8_t* cells = world_chunk_write(world, x >> CHUNK_SHIFT, cy, cz)->blocks + row;
+        int first = -1;
+        int last = -1;
+        for (int xi = x; xi < seg_end; xi++) {
+            uint8_t t = src ? src[xi - x0] : fill;
+            if (skip_air && t == BLOCK_AIR) continue;
+            uint8_t* cell = &cells[xi & CHUNK_MASK];
+            if (*cell == t) continue;
+            *cell = t;
+            world_heightmap_update(world, xi, y, z, (BlockType)t);
+            if (first < 0) first = xi;
+            last = xi;
+            batch_record(b, xi, y, z);
+        }
+        if (first >= 0) {
+            world_mark_dirty(world, first, y, z);
+            if (last != first) world_mark_dirty(world, last, y, z);
+        }
+        x = seg_end;
+    }
+}
+
+static bool clip_box(const World* world, int* x0, int* y0, int* z0, int* x1, int* y1, int* z1) {
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*z0 < 0) *z0 = 0;
+    if (*x1 > world->w) *x1 = world->w;
+    if (*y1 > world->h) *y1 = world->h;
+    if (*z1 > world->d) *z1 = world->d;
+    return *x0 < *x1 && *y0 < *y1 && *z0 < *z1;
+}
+
+int world_fill_box(World* world, int x0, int y0, int z0, int x1, int y1, int z1, BlockType t) {
+    if (!world || !world->chunks) return 0;
+    if (!clip_box(world, &x0, &y0, &z0, &x1, &y1, &z1)) return 0;
+
+    EditBatch b;
+    batch_begin(&b, world);
+    for (int y = y0; y < y1; y++) {
+        for (int z = z0; z < z1; z++) {
+            batch_row(&b, y, z, x0, x1, NULL, (uint8_t)t, false);
+        }
+    }
+    return batch_end(&b);
+}
+
+int world_fill_sphere(World* world, float cx, float cy, float cz, float radius, BlockType t) {
+    if (!world || !world->chunks || radius <= 0.0f) return 0;
+
+    int y0 = (int)floorf(cy - radius);
+    int y1 = (int)ceilf(cy + radius) + 1;
+    int z0 = (int)floorf(cz - radius);
+    int z1 = (int)ceilf(cz + radius) + 1;
+    int x0 = 0, x1 = world->w;
+    if (!clip_box(world, &x0, &y0, &z0, &x1, &y1, &z1)) return 0;
+
+    EditBatch b;
+    batch_begin(&b, world);
+    float r2 = radius * radius;
+    for (int y = y0; y < y1; y++) {
+        float dy = (float)y + 0.5f - cy;
+        for (int z = z0; z < z1; z++) {
+            float dz = (float)z + 0.5f - cz;
+            float rem = r2 - dy * dy - dz * dz;
+            if (rem < 0.0f) continue;
+            float half = sqrtf(rem);
+            int sx0 = (int)ceilf(cx - half - 0.5f);
+            int sx1 = (int)floorf(cx + half - 0.5f) + 1;
+            if (sx0 < 0) sx0 = 0;
+            if (sx1 > world->w) sx1 = world->w;
+            if (sx0 < sx1) batch_row(&b, y, z, sx0, sx1, NULL, (uint8_t)t, false);
+        }
+    }
+    return batch_end(&b);
+}
+
+int world_carve_sphere(World* world, float cx, float cy, float cz, float radius) {
+    return world_fill_sphere(world, cx, cy, cz, radius, BLOCK_AIR);
+}
+
+int world_apply_edits(World* world, const BlockEdit* edits, size_t count) {
+    if (!world || !world->chunks) return 0;
+
+    EditBatch b;
+    batch_begin(&b, world);
+    for (size_t i = 0; i < count; i++) {
+        const BlockEdit* e = &edits[i];
+        if (!world_in_bounds(world, e->x, e->y, e->z)) continue;
+        batch_row(&b, e->y, e->z, e->x, e->x + 1, NULL, (uint8_t)e->type, false);
+    }
+    return batch_end(&b);
+}
+
+bool world_copy_volume(const World* world, int x0, int y0, int z0, int w, int h, int d, BlockVolume* out_volume) {
+    memset(out_volume, 0, sizeof(*out_volume));
+    if (!world || !world->chunks || w <= 0 || h <= 0 || d <= 0) return false;
+
+    out_volume->blocks = (uint8_t*)mem_calloc(MEM_TAG_SCRATCH, (size_t)w * (size_t)h * (size_t)d, 1);
+    if (!out_volume->blocks) return false;
+    out_volume->w = w;
+    out_volume->h = h;
+    out_volume->d = d;
+
+    int cx0 = x0, cy0 = y0, cz0 = z0;
+    int cx1 = x0 + w, cy1 = y0 + h, cz1 = z0 + d;
+    if (!clip_box(world, &cx0, &cy0, &cz0, &cx1, &cy1, &cz1)) return true;
+
+    for (int y = cy0; y < cy1; y++) {
+        for (int z = cz0; z < cz1; z++) {
+            uint8_t* dst = &out_volume->blocks[block_volume_index(out_volume, 0, y - y0, z - z0)];
+            int row = chunk_local_index(0, y & CHUNK_MASK, z & CHUNK_MASK);
+            for (int x = cx0; x < cx1;) {
+                int seg_end = ((x >> CHUNK_SHIFT) + 1) << CHUNK_SHIFT;
+                if (seg_end > cx1) seg_end = cx1;
+                const Chunk* c = world_chunk(world, x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+                memcpy(&dst[x - x0], &c->blocks[row + (x & CHUNK_MASK)], (size_t)(seg_end - x));
+                x = seg_end;
+            }
+        }
+    }
+    return true;
+}
+
+int world_paste_volume(World* world, const BlockVolume* volume, int x0, int y0, int z0, bool skip_air) {
+    if (!world || !world->chunks || !volume || !volume->blocks) return 0;
+
+    int cx0 = x0, cy0 = y0, cz0 = z0;
+    int cx1 = x0 + volume->w, cy1 = y0 + volume->h, cz1 = z0 + volume->d;
+    if (!clip_box(world, &cx0, &cy0, &cz0, &cx1, &cy1, &cz1)) return 0;
+
+    EditBatch b;
+    batch_begin(&b, world);
+    for (int y = cy0; y < cy1; y++) {
+        for (int z = cz0; z < cz1; z++) {
+            const uint8_t* src = &volume->blocks[block_volume_index(volume, cx0 - x0, y - y0, z - z0)];
+            batch_row(&b, y, z, cx0, cx1, src, 0, skip_air);
+        }
+    }
+    return batch_end(&b);
+}
+
+void block_volume_free(BlockVolume* volume) {
+    if (!volume) return;
+    mem_free(MEM_TAG_SCRATCH, volume->blocks);
+    memset(volume, 0, sizeof(*volume));
+}
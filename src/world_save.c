@@ -0,0 +1,215 @@
+#include "world_save.h"
+
+#include "chunk_slab.h"
+#include "mem_track.h"
+#include "thread.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WORLD_SAVE_MAGIC 0x56415357u
+#define WORLD_SAVE_VERSION 2u
+#define WORLD_SAVE_HAS_MESHES 0x1u
+
+typedef struct WorldSaveHeader {
+    uint32_t magic;
+    uint32_t version;
+    int32_t w;
+    int32_t h;
+    int32_t d;
+    uint32_t chunk_count;
+    uint32_t flags;
+    uint32_t vertex_floats;
+} WorldSaveHeader;
+
+static size_t encode_runs(const uint8_t* src, size_t n, uint8_t* out) {
+    size_t o = 0;
+    for (size_t i = 0; i < n;) {
+        uint8_t v = src[i];
+        size_t run = 1;
+        while (i + run < n && run < 255 && src[i + run] == v) run++;
+        out[o++] = (uint8_t)run;
+        out[o++] = v;
+        i += run;
+    }
+    return o;
+}
+
+static const uint8_t* decode_runs(const uint8_t* in, const uint8_t* end, uint8_t* dst, size_t n) {
+    size_t o = 0;
+    while (o < n) {
+        if (end - in < 2 || in[0] == 0 || in[0] > n - o) return NULL;
+        memset(&dst[o], in[1], in[0]);
+        o += in[0];
+        in += 2;
+    }
+    return in;
+}
+
+size_t world_save_encode_chunk(const Chunk* c, uint8_t* out) {
+    size_t n = encode_runs(c->blocks, sizeof(c->blocks), out);
+    return n + encode_runs(c->light, sizeof(c->light), out + n);
+}
+
+bool world_save_decode_chunk(const uint8_t* in, size_t size, Chunk* out) {
+    const uint8_t* end = in + size;
+    in = decode_runs(in, end, out->blocks, sizeof(out->blocks));
+    if (in) in = decode_runs(in, end, out->light, sizeof(out->light));
+    out->dirty = false;
+    return in == end;
+}
+
+static bool write_world(const World* world, const WorldSnapshot* snap, const Mesh* meshes, const char* path, WorldSaveStats* out_stats) {
+    WorldSaveStats stats = { 0 };
+    if (out_stats) *out_stats = stats;
+    if (!world || !world->chunks) return false;
+
+    uint8_t* record = (uint8_t*)mem_alloc(MEM_TAG_SCRATCH, WORLD_SAVE_MAX_RECORD);
+    Chunk* scratch = snap ? (Chunk*)mem_alloc(MEM_TAG_SCRATCH, sizeof(Chunk)) : NULL;
+    if (!record || (snap && !scratch)) {
+        mem_free(MEM_TAG_SCRATCH, record);
+        mem_free(MEM_TAG_SCRATCH, scratch);
+        return false;
+    }
+
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE* f = fopen(tmp_path, "wb");
+    if (!f) {
+        mem_free(MEM_TAG_SCRATCH, record);
+        mem_free(MEM_TAG_SCRATCH, scratch);
+        return false;
+    }
+
+    WorldSaveHeader hdr = { WORLD_SAVE_MAGIC, WORLD_SAVE_VERSION, world->w, world->h, world->d, (uint32_t)world_chunk_count(world),
+        meshes ? WORLD_SAVE_HAS_MESHES : 0u, MESH_VERTEX_FLOATS };
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+    stats.file_bytes = sizeof(hdr);
+    for (uint32_t i = 0; ok && i < hdr.chunk_count; i++) {
+        const Chunk* chunk = snap ? world_snapshot_chunk(snap, (int)i, scratch) : world_chunk_at(world, (int)i);
+        if (!chunk) {
+            ok = false;
+            break;
+        }
+        uint32_t size = (uint32_t)world_save_encode_chunk(chunk, record);
+        ok = fwrite(&size, sizeof(size), 1, f) == 1 && fwrite(record, 1, size, f) == size;
+        stats.chunks++;
+        stats.raw_bytes += 2 * CHUNK_VOLUME;
+        stats.file_bytes += sizeof(size) + size;
+    }
+    for (uint32_t i = 0; ok && meshes && i < hdr.chunk_count; i++) {
+        uint32_t count = (uint32_t)meshes[i].vertex_count;
+        size_t floats = (size_t)count * MESH_VERTEX_FLOATS;
+        ok = fwrite(&count, sizeof(count), 1, f) == 1 && (floats == 0 || fwrite(meshes[i].vertices, sizeof(float), floats, f) == floats);
+        stats.mesh_bytes += floats * sizeof(float);
+        stats.file_bytes += sizeof(count) + floats * sizeof(float);
+    }
+    ok = (fclose(f) == 0) && ok;
+    mem_free(MEM_TAG_SCRATCH, record);
+    mem_free(MEM_TAG_SCRATCH, scratch);
+
+    if (!ok) {
+        remove(tmp_path);
+        return false;
+    }
+    remove(path);
+    if (rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return false;
+    }
+    if (out_stats) *out_stats = stats;
+    return true;
+}
+
+bool world_save_write(const World* world, const Mesh* meshes, const char* path, WorldSaveStats* out_stats) {
+    return write_world(world, NULL, meshes, path, out_stats);
+}
+
+static bool read_meshes(FILE* f, int count, Mesh** out_meshes) {
+    Mesh* meshes = (Mesh*)mem_calloc(MEM_TAG_MESH, (size_t)count, sizeof(Mesh));
+    bool ok = meshes != NULL;
+    for (int i = 0; ok && i < count; i++) {
+        uint32_t vertex_count;
+        ok = fread(&vertex_count, sizeof(vertex_count), 1, f) == 1 && vertex_count <= CHUNK_VOLUME * 36u;
+        if (!ok || vertex_count == 0) continue;
+        size_t floats = (size_t)vertex_count * MESH_VERTEX_FLOATS;
+        meshes[i].vertices = (float*)mem_alloc(MEM_TAG_MESH, floats * sizeof(float));
+        ok = meshes[i].vertices && fread(meshes[i].vertices, sizeof(float), floats, f) == floats;
+        if (ok) meshes[i].vertex_count = vertex_count;
+    }
+    if (!ok) {
+        world_free_chunk_meshes(meshes, count);
+        return false;
+    }
+    *out_meshes = meshes;
+    return true;
+}
+
+bool world_save_read(World* world, const char* path, Mesh** out_meshes) {
+    if (out_meshes) *out_meshes = NULL;
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+
+    WorldSaveHeader hdr;
+    bool ok = fread(&hdr, sizeof(hdr), 1, f) == 1 && hdr.magic == WORLD_SAVE_MAGIC && hdr.version == WORLD_SAVE_VERSION &&
+        hdr.vertex_floats == MESH_VERTEX_FLOATS;
+    ok = ok && world_init(world, hdr.w, hdr.h, hdr.d);
+    if (!ok) {
+        fclose(f);
+        return false;
+    }
+
+    uint8_t* record = (uint8_t*)mem_alloc(MEM_TAG_SCRATCH, WORLD_SAVE_MAX_RECORD);
+    ok = record && (uint32_t)world_chunk_count(world) == hdr.chunk_count;
+    for (uint32_t i = 0; ok && i < hdr.chunk_count; i++) {
+        uint32_t size;
+        ok = fread(&size, sizeof(size), 1, f) == 1 && size <= WORLD_SAVE_MAX_RECORD &&
+            fread(record, 1, size, f) == size &&
+            world_save_decode_chunk(record, size, world->chunks[i]);
+    }
+    mem_free(MEM_TAG_SCRATCH, record);
+    if (ok && out_meshes && (hdr.flags & WORLD_SAVE_HAS_MESHES)) ok = read_meshes(f, (int)hdr.chunk_count, out_meshes);
+    fclose(f);
+    if (!ok) {
+        world_shutdown(world);
+        return false;
+    }
+
+    world->light_ready = true;
+    world_build_heightmaps(world);
+    return true;
+}
+
+static void save_thread_main(void* user) {
+    WorldSaveJob* job = (WorldSaveJob*)user;
+    job->ok = write_world(&job->snap.view, &job->snap, NULL, job->path, &job->stats);
+    chunk_slab_thread_flush();
+    atomic_store(&job->done, true);
+}
+
+bool world_save_start(WorldSaveJob* job, World* world, const char* path) {
+    memset(job, 0, sizeof(*job));
+    atomic_init(&job->done, false);
+    snprintf(job->path, sizeof(job->path), "%s", path);
+    if (!world_snapshot_take(&job->snap, world)) return false;
+    if (!thread_create(&job->thread, save_thread_main, job)) {
+        world_snapshot_release(&job->snap);
+        job->thread = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool world_save_poll(WorldSaveJob* job) {
+    return !job->thread || atomic_load(&job->done);
+}
+
+bool world_save_finish(WorldSaveJob* job) {
+    if (!job->thread) return false;
+    thread_join(job->thread);
+    job->thread = NULL;
+    world_snapshot_release(&job->snap);
+    return job->ok;
+}
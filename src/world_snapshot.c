@@ -0,0 +1,78 @@
+#include "world_snapshot.h"
+
+#include "chunk_cache.h"
+#include "chunk_slab.h"
+#include "mem_track.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static bool hold_evicted_chunks(WorldSnapshot* snap, ChunkCache* cache, int n) {
+    snap->slots = (uint32_t*)mem_alloc(MEM_TAG_WORLD, (size_t)n * sizeof(uint32_t));
+    snap->uniform = (uint8_t*)mem_alloc(MEM_TAG_WORLD, (size_t)n * 2);
+    if (!snap->slots || !snap->uniform || !chunk_cache_hold_records(cache)) return false;
+    snap->cache = cache;
+
+    bool stored = false;
+    for (int i = 0; i < n; i++) {
+        snap->slots[i] = CHUNK_CACHE_NO_SLOT;
+        if (chunk_cache_stored_record(cache, i, &snap->slots[i], &snap->uniform[i * 2]) && snap->slots[i] != CHUNK_CACHE_NO_SLOT) {
+            stored = true;
+        }
+    }
+    if (stored) snap->records = fopen(cache->backing_path, "rb");
+    return !stored || snap->records;
+}
+
+bool world_snapshot_take(WorldSnapshot* snap, World* world) {
+    memset(snap, 0, sizeof(*snap));
+    if (!world || !world->chunks) return false;
+    if (!world_adopt_external_chunks(world)) return false;
+
+    int n = world_chunk_count(world);
+    Chunk** chunks = (Chunk**)mem_alloc(MEM_TAG_WORLD, (size_t)n * sizeof(Chunk*));
+    if (!chunks) return false;
+    memcpy(chunks, world->chunks, (size_t)n * sizeof(Chunk*));
+    snap->view = *world;
+    snap->view.chunks = chunks;
+    snap->view.columns = NULL;
+    snap->view.cache = NULL;
+
+    if (world->cache && !hold_evicted_chunks(snap, world->cache, n)) {
+        memset(chunks, 0, (size_t)n * sizeof(Chunk*));
+        world_snapshot_release(snap);
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        if (chunks[i]) chunk_slab_retain(chunks[i]);
+    }
+    return true;
+}
+
+void world_snapshot_release(WorldSnapshot* snap) {
+    if (!snap || !snap->view.chunks) return;
+    int n = world_chunk_count(&snap->view);
+    for (int i = 0; i < n; i++) {
+        if (snap->view.chunks[i]) chunk_slab_release(snap->view.chunks[i]);
+    }
+    if (snap->records) fclose(snap->records);
+    if (snap->cache) chunk_cache_release_records(snap->cache);
+    mem_free(MEM_TAG_WORLD, snap->slots);
+    mem_free(MEM_TAG_WORLD, snap->uniform);
+    mem_free(MEM_TAG_WORLD, snap->view.chunks);
+    memset(snap, 0, sizeof(*snap));
+}
+
+const Chunk* world_snapshot_chunk(const WorldSnapshot* snap, int index, Chunk* scratch) {
+    const Chunk* chunk = snap->view.chunks[index];
+    if (chunk) return chunk;
+    if (!snap->slots) return NULL;
+    if (snap->slots[index] == CHUNK_CACHE_NO_SLOT) {
+        memset(scratch->blocks, snap->uniform[index * 2], sizeof(scratch->blocks));
+        memset(scratch->light, snap->uniform[index * 2 + 1], sizeof(scratch->light));
+        return scratch;
+    }
+    return chunk_cache_read_record(snap->records, snap->slots[index], scratch) ? scratch : NULL;
+}